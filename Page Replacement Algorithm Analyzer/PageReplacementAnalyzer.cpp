@@ -17,24 +17,128 @@
  **********************************************************************************/
 
 #include <bits/stdc++.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAS_MMAP 1
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define HAS_PERF_EVENTS 1
+#endif
 using namespace std;
 
-// Constants to represent types of statistics
-const int MISS = 0;
-const int TOTAL = 1;
+// References fed to every online algorithm before the fused driver moves on (64 KiB of page ids)
+const int FUSED_BLOCK_SIZE = 1 << 14;
+
+// Trace file layout: magic, version, id width in bytes, page size, reference count, largest page id
+const char TRACE_MAGIC[4] = {'P', 'R', 'A', 'T'};
+const uint32_t TRACE_VERSION = 1;
+
+// Checkpoint file layout: magic, version, the run it belongs to, then one record per finished page size
+const char CHECKPOINT_MAGIC[4] = {'P', 'R', 'A', 'C'};
+const uint32_t CHECKPOINT_VERSION = 1;
 
 // Forward Declarations
 class history;
 class handler;
 class input;
 class output;
+class config;
+class resultTable;
+class perfCounters;
+class threadPool;
 class analyze;
-class Process;
+class process;
+class workload;
+class uniformWorkload;
+class zipfWorkload;
+class scanWorkload;
+class loopWorkload;
+class phaseWorkload;
+class mixtureWorkload;
+class traceFile;
+class traceWriter;
+class checkpoint;
+class traceView;
+class arena;
 class RAM;
+class onlineRAM;
 class algoData;
 class FIFO;
 class LRU;
 class MRU;
+class missRatioCurve;
+class stackDistance;
+class sampledStackDistance;
+class LRUStack;
+class LRUSampled;
+class pageList;
+class LRUList;
+class MRUList;
+class FIFORing;
+class CLOCK;
+class GCLOCK;
+class ARC;
+class OPTHeap;
+class OPTStack;
+
+// Counts of one simulation, or of several added together
+struct stats {
+    int64_t missCount;                                             // Page faults
+    int64_t total;                                                 // References
+};
+
+// Cost of running an algorithm, summed over every block and simulation it was timed on. Counters
+// that could not be opened stay 0.
+struct perfSample {
+    int64_t nanoseconds;                                           // Wall-clock time
+    int64_t cycles;                                                // CPU cycles in user space
+    int64_t instructions;                                          // Instructions retired in user space
+    int64_t cacheMisses;                                           // Last-level cache misses
+    int64_t branchMisses;                                          // Mispredicted branches
+};
+
+// Flat table of counts indexed by (row, column), one array per statistic. The history holds a row
+// per page size and a column per algoID; the accumulators of a configuration hold a row per worker.
+class resultTable {
+    int noOfColumns;                                               // Cells per row
+    vector<int64_t> missCount;                                     // [row * noOfColumns + column]
+    vector<int64_t> total;                                         // [row * noOfColumns + column]
+
+public:
+    resultTable(int noOfRows = 0, int noOfColumns = 0);            // Zeroed table
+
+    int getRows() const;                                           // Number of rows
+    int getColumns() const;                                        // Cells per row
+    stats get(int row, int column) const;                          // Counts of one cell
+    void add(int row, int column, stats counts);                   // Accumulate into one cell
+    void addRow(int row, const resultTable &source, int sourceRow); // Accumulate a row of another table
+    void appendRow(const resultTable &source, int sourceRow);      // Copy a row of another table after the last one
+};
+
+// Hit counts of a stack algorithm for every frame count of a single trace, or of several added together
+class missRatioCurve {
+    vector<long long> hitsUpTo;                                    // hitsUpTo[k] = hits with k frames, k in [0, pageIDWidth]
+    long long total;                                               // Number of references in the trace
+
+public:
+    missRatioCurve();                                              // Empty curve of no references
+    missRatioCurve(vector<long long> &&hitsUpTo, long long total); // Constructor
+
+    static missRatioCurve createLRUCurve(traceView pageID);        // Mattson stack-distance pass, O(n log m)
+    static missRatioCurve createOPTCurve(traceView pageID, int maxFrames = 0); // Priority-stack pass of Belady's MIN
+    static missRatioCurve createSampledLRUCurve(traceView pageID, int sampleBudget); // Approximate LRU curve from a page sample
+    long long getMissCount(int noOfRAMPages) const;                // Misses with the given number of frames
+    long long getTotal() const;                                    // Number of references
+    double getMissRatio(int noOfRAMPages) const;                   // Misses / references
+    int getMaxFrames() const;                                      // Frame counts above this miss as often as it does
+    void add(const missRatioCurve &curve);                         // Add the counts of the curve of another trace
+};
 
 // Singleton class to maintain history of input-output pairs
 class history {
@@ -49,6 +153,9 @@ public:
     void updateHistory(input *in, output *out);                    // Append new input-output entry
     pair<input *, output *> getLastElement();                      // Retrieve most recent entry
     void printCurrentStats();                                      // Display statistics from last entry
+    void printProfile();                                           // Display the cost of every algorithm from last entry
+    bool saveCurves(const string &path);                           // Write the miss-ratio curves from last entry as CSV
+    static void printTable(const string &title, vector<vector<string>> table); // Print rows of cells as a bordered table
 };
 
 // Central controller class to manage simulation parameters
@@ -60,8 +167,9 @@ class handler {
     handler(int RAMSize, int noOfProcess, int processSize);        // Private constructor
 
 public:
-    static handler *createHandler();                               // Factory method to instantiate handler
-    void analyzeOnAllPageSize();                                   // Run analysis for varying page sizes
+    static handler *createHandler();                               // Factory method, prompts for the inputs
+    static handler *createHandler(int noOfProcess, int RAMSize, int processSize); // Factory method for given inputs
+    bool analyzeOnAllPageSize();                                   // Run analysis for varying page sizes, false if it cannot resume
     void printAnalyzedData();                                      // Output the analyzed data
 };
 
@@ -70,29 +178,298 @@ class analyze {
     int noOfProcess;                                               // Number of processes to simulate
     int noOfPages;                                                 // Total pages in a process
     int noOfRAMPages;                                              // Pages that can fit in RAM
-    vector<vector<int>> curOutput;                                 // Temporary output holder
-
-    analyze(int noOfProcess, int RAMSize, int processSize);        // Private constructor
+    int pageSize;                                                  // Page size of this configuration
+    int processSize;                                               // Units of memory in a process
+    resultTable curOutput;                                         // Counts of this configuration, a single row
+    resultTable partialOutput;                                     // Per-worker accumulators, a row per worker
+    vector<perfSample> curProfile;                                 // Cost of each algorithm in this configuration
+    vector<perfSample> partialProfile;                             // Per-worker costs, [worker * columns + algoID]
+    atomic<int> pendingTasks;                                      // Simulations still running for this configuration
+    bool finished;                                                 // curOutput holds the final counts
+    analyze *representative;                                       // Equivalent configuration whose counts this one reports, NULL if none
+    missRatioCurve LRUCurve;                                       // LRU curve summed over processes, empty unless --curve
+    missRatioCurve OPTCurve;                                       // OPT curve summed over processes, empty unless OPT is selected
+    mutex curveLock;                                               // Serializes adding the curves of processes
+
+    analyze(int noOfProcess, int noOfPages, int noOfRAMPages, int pageSize, int processSize); // Private constructor
+    friend class arena;
 
 public:
-    static analyze *createAnalyze(int noOfProcess, int RAMSize, int processSize, int pageSize); // Factory method
-    void runProcesses();                                           // Initiate execution of processes
+    static analyze *createAnalyze(arena &memory, int noOfProcess, int RAMSize, int processSize, int pageSize); // Factory method, owned by memory
+    static void runAll(const vector<analyze *> &analyses, checkpoint *progress = NULL); // Simulate several configurations of one process size on the pool
+    void restoreOutput(const resultTable &savedOutput);            // Take counts saved by an earlier run instead of simulating
 
 private:
-    void mergeOutput(vector<vector<int>> curOutput);               // Combine individual results
+    string traceFileName(int processIndex) const;                  // File of a process in the replay/record directories
+    process *loadProcess(int processIndex);                        // Replay the process trace if present, else NULL
+    process *createProcess(shared_ptr<const vector<int>> units, shared_ptr<workload> pattern, uint64_t key); // Process over the shared unit trace
+    void recordProcess(int processIndex, process *curProcess);     // Save the trace when recording
+    void runAlgorithms(int worker, process *curProcess, const vector<algoData *> &algos, arena &scratch); // Simulate algorithms on one process
+    void runCurves(process *curProcess);                           // Add the miss-ratio curves of one process
+    void finishOutput(checkpoint *progress);                       // Reduce worker accumulators, then checkpoint them
+    void publishOutput();                                          // Append the counts to the history
+};
+
+// Access pattern a trace is drawn from. Reference i of the trace with a given key is a pure function
+// of (key, i), built on a SplitMix64 finalizer over key + i * golden ratio, so any range of a trace
+// can be produced independently and in any order: traces are generated concurrently, streamed chunk
+// by chunk, or regenerated alone from the key of their process. Patterns are selected per run by a
+// spec such as "zipf:0.99" or "zipf:0.99@0.7+scan@0.3" (see createWorkload).
+class workload {
+protected:
+    int noOfPages;                                                 // References lie in [1, noOfPages]
+
+public:
+    workload(int noOfPages);                                       // Constructor
+    virtual ~workload() {}
+
+    int width() const;                                             // Largest page id produced
+    virtual void fillAt(int *chunk, uint64_t key, size_t first, size_t count) const = 0; // References [first, first + count) of trace key
+    static workload *createWorkload(const string &spec, int noOfPages); // Factory method, NULL if spec is malformed
+    static uint64_t mix(uint64_t z);                               // SplitMix64 finalizer
+    static uint64_t random(uint64_t key, size_t index);            // Random bits of reference index of trace key
+    static uint64_t processKey(uint64_t seed, int processIndex);   // Trace key of one process of a sweep
+    static uint32_t scale(uint64_t bits, uint32_t range);          // Top 32 bits mapped onto [0, range)
+};
+
+// Every page equally likely
+class uniformWorkload : public workload {
+public:
+    uniformWorkload(int noOfPages) : workload(noOfPages) {}
+
+    void fillAt(int *chunk, uint64_t key, size_t first, size_t count) const override;
+};
+
+// Page p drawn with probability proportional to 1 / p^alpha, sampled in O(1) from an alias table
+class zipfWorkload : public workload {
+    vector<uint32_t> threshold;                                    // Keep the column below this, else take its alias
+    vector<int> alias;                                             // Page that shares each column
+
+public:
+    zipfWorkload(int noOfPages, double alpha);                     // Builds the alias table (Vose)
+
+    void fillAt(int *chunk, uint64_t key, size_t first, size_t count) const override;
+};
+
+// Every page in order, wrapping around, from a start page chosen by the key
+class scanWorkload : public workload {
+public:
+    scanWorkload(int noOfPages) : workload(noOfPages) {}
+
+    void fillAt(int *chunk, uint64_t key, size_t first, size_t count) const override;
+};
+
+// A window of consecutive pages visited in order over and over
+class loopWorkload : public workload {
+    double fraction;                                               // Window size as a fraction of the pages
+
+public:
+    loopWorkload(int noOfPages, double fraction) : workload(noOfPages), fraction(fraction) {}
+
+    void fillAt(int *chunk, uint64_t key, size_t first, size_t count) const override;
+};
+
+// Uniform references inside a working set of consecutive pages that moves to a random place
+// at the start of every phase
+class phaseWorkload : public workload {
+    double fraction;                                               // Working set size as a fraction of the pages
+    double phaseLength;                                            // References per phase, in multiples of the pages
+
+public:
+    phaseWorkload(int noOfPages, double fraction, double phaseLength)
+        : workload(noOfPages), fraction(fraction), phaseLength(phaseLength) {}
+
+    void fillAt(int *chunk, uint64_t key, size_t first, size_t count) const override;
+};
+
+// Each reference taken from one of several patterns, chosen at random by weight
+class mixtureWorkload : public workload {
+    vector<unique_ptr<workload>> components;                       // Patterns mixed together
+    vector<uint32_t> upperBound;                                   // Cumulative weights scaled to 2^32
+
+public:
+    mixtureWorkload(int noOfPages, vector<unique_ptr<workload>> &&components, const vector<double> &weights);
+
+    void fillAt(int *chunk, uint64_t key, size_t first, size_t count) const override;
+};
+
+// Read-only binary trace file: a 32-byte header followed by packed page ids in native byte order.
+// Files with 4-byte ids are memory-mapped and handed to the algorithms in place; 1- and 2-byte ids
+// are widened once on load. The engines index flat arrays by page id, so a file is rejected unless
+// every id lies in [1, noOfPages] of its header.
+class traceFile {
+    struct header {
+        char magic[4];                                             // TRACE_MAGIC
+        uint32_t version;                                          // TRACE_VERSION
+        uint32_t idWidth;                                          // Bytes per page id: 1, 2 or 4
+        uint32_t pageSize;                                         // Page size the ids refer to, 0 if unknown
+        uint64_t count;                                            // Number of references
+        uint32_t noOfPages;                                        // Largest page id in the file
+        uint32_t reserved;                                         // Keeps the ids 8-byte aligned
+    };
+    friend class traceWriter;
+
+    void *mapped;                                                  // Mapped file, NULL when read into memory
+    size_t mappedLength;                                           // Length of the mapping
+    vector<int> widened;                                           // Page ids when they could not be used in place
+    const int *ids;                                                // First page id
+    size_t count;                                                  // Number of references
+    int noOfPages;                                                 // Largest page id
+
+    traceFile();                                                   // Private constructor
+
+public:
+    static traceFile *openTrace(const string &path);               // NULL if missing or malformed (reported)
+    ~traceFile();                                                  // Unmaps the file
+
+    traceView getView() const;                                     // The whole trace
+};
+
+// Writes a binary trace file incrementally, always with 4-byte ids so it can be mapped in place. The
+// file is written under a temporary name and renamed once complete, so an interrupted recording
+// never shows up under the name a replay looks for.
+class traceWriter {
+    string path;                                                   // Name of the finished file
+    ofstream file;                                                 // Destination, path + ".tmp" until close
+    traceFile::header fileHeader;                                  // Rewritten with the final counts on close
+    int largestID;                                                 // Largest page id written so far
+
+public:
+    traceWriter(const string &path, int pageSize);                 // Opens the file and reserves the header
+    bool append(traceView block);                                  // Add references at the end
+    bool close();                                                  // Finish the header and rename, false on any I/O error
+};
+
+// Append-only record of the page sizes a sweep has finished, so an interrupted sweep can resume.
+// The header identifies the run (inputs, seed, and a fingerprint of every other setting that changes
+// the counts); each record holds the counts of one page size and is flushed as soon as it is
+// written. A record cut short by a crash is dropped and overwritten on resume.
+class checkpoint {
+    struct header {
+        char magic[4];                                             // CHECKPOINT_MAGIC
+        uint32_t version;                                          // CHECKPOINT_VERSION
+        int32_t RAMSize;                                           // Inputs of the run
+        int32_t noOfProcess;
+        int32_t processSize;
+        uint32_t noOfColumns;                                      // Result columns per record, including column 0
+        uint64_t seed;                                             // Seed of the generated traces
+        uint64_t fingerprint;                                      // Hash of the workload, policies, engines and replay settings
+    };
+
+    fstream file;                                                  // Open for appending records
+    vector<int> columns;                                           // algoID of each column of a record, column 0 first
+    mutex lock;                                                    // Serializes records written by different workers
+
+    checkpoint();                                                  // Private constructor
+
+public:
+    static checkpoint *openCheckpoint(const string &path, int RAMSize, int noOfProcess, int processSize,
+                                      map<int, resultTable> &savedOutput); // Create or resume, NULL if it belongs to another run
+    static uint64_t runFingerprint();                              // Hash of the settings beyond the inputs that change the counts
+    bool saveOutput(int pageSize, const resultTable &curOutput);   // Record a finished page size
+};
+
+// Hardware counters of the calling thread, read as one perf_event_open group (cycles, instructions,
+// last-level cache misses, branch misses; user space only). Each thread opens its own group the
+// first time it asks, and any event the kernel or the CPU refuses is left out, down to wall-clock
+// time alone when perf events are unavailable altogether.
+class perfCounters {
+    static const int NO_OF_EVENTS = 4;                             // cycles, instructions, cacheMisses, branchMisses
+    int leader;                                                    // Group file descriptor, -1 if none opened
+    int descriptor[NO_OF_EVENTS];                                  // File descriptor of each event, -1 if missing
+    int slot[NO_OF_EVENTS];                                        // Position of each event in a group read, -1 if missing
+    int noOfOpened;                                                // Events in the group
+
+    perfCounters();                                                // Private constructor, opens the group
+
+public:
+    ~perfCounters();
+    static perfCounters *getInstance();                            // Counters of the calling thread
+    perfSample read() const;                                       // Current totals, including the wall clock
+    static void accumulate(perfSample &target, const perfSample &start, const perfSample &finish); // Add finish - start
 };
 
 // Class representing a simulated process with generated page references
+// A generated process references units of memory (bytes, or whatever the sizes are counted in)
+// rather than pages: its unit trace is drawn once over [1, processSize] and every page size reads
+// a prefix of it, unit u falling on page (u - 1) / pageSize + 1. Rows of a sweep are therefore
+// computed on the same references, and each keeps the length of 100 references per page.
 class process {
     int noOfRAMPages;                                              // RAM size in pages
     int noOfPages;                                                 // Total number of page references
-    vector<int> pageID;                                            // Generated page reference string
+    int pageSize;                                                  // Units per page
+    size_t noOfReferences;                                         // Length of the page trace
+    shared_ptr<const vector<int>> units;                           // Unit trace shared by every page size, NULL when streamed
+    shared_ptr<workload> pattern;                                  // Workload a streamed unit trace is regenerated from
+    uint64_t key;                                                  // Generator key of the unit trace
+    shared_ptr<traceFile> replayed;                                // Mapped trace file the process was loaded from
+
+    process(int noOfPages, int noOfRAMPages);                      // Private constructor
+    void fillPages(int *chunk, size_t first, size_t count) const;  // Page ids of references [first, first + count)
+
+public:
+    static process *createProcess(int noOfPages, int noOfRAMPages, int pageSize, shared_ptr<const vector<int>> units,
+                                  shared_ptr<workload> pattern, uint64_t key); // Factory method, page trace mapped from units
+    static void mapToPages(const int *units, int *pageID, size_t count, int pageSize); // Page of each unit
+    static process *loadProcess(const string &path, int noOfRAMPages); // Replay a trace file, NULL if unusable
+    bool saveTrace(const string &path, int pageSize);              // Write the trace as a trace file
+    void runAlgorithms(const vector<algoData *> &algos, arena &scratch, resultTable &counts, int row,
+                       perfSample *profile = NULL);                // Execute simulation, add its counts to a row and its costs to profile[algoID]
+    missRatioCurve createLRUCurve() const;                         // LRU curve of the page trace, streamed block by block
+    missRatioCurve createOPTCurve() const;                         // OPT curve of the page trace, materialized for the pass
+};
+
+// Non-owning, read-only view over a page reference string.
+// A trace is materialized once per process and shared by every algorithm through this view.
+class traceView {
+    const int *data;                                               // First page id of the trace
+    size_t length;                                                 // Number of references
+    int pageIDWidth;                                               // Page ids lie in [1, pageIDWidth]
+
+public:
+    traceView();                                                   // Empty view
+    traceView(const int *data, size_t length, int pageIDWidth);    // View over raw storage
+    traceView(const vector<int> &pageID, int pageIDWidth);         // View over a vector (must outlive the view)
+
+    size_t size() const;                                           // Number of references
+    int width() const;                                             // Largest page id that may appear
+    const int &operator[](size_t i) const;                         // Page id of the i-th reference
+    const int *begin() const;                                      // Iteration support
+    const int *end() const;
+    traceView slice(size_t offset, size_t count) const;            // Sub-view of count references from offset
+};
+
+// Monotonic region for short-lived objects: create() bumps a pointer through large blocks and
+// release() destroys everything created since the last release at once. The blocks are kept (merged
+// into one if the region had to grow), so a region that is released and refilled with objects of
+// the same sizes stops calling the global allocator after its first round.
+class arena {
+    struct block {
+        unique_ptr<char[]> data;                                   // Storage of the block
+        size_t size;                                               // Bytes in the block
+    };
 
-    process(int noOfPages, int noOfRAMPages, vector<int> pageID); // Private constructor
+    vector<block> blocks;                                          // Filled front to back
+    size_t currentBlock;                                           // Block objects are being placed in
+    size_t used;                                                   // Bytes taken from the current block
+    vector<pair<void *, void (*)(void *)>> destructors;            // Objects to destroy on release, in creation order
+
+    void *allocate(size_t size, size_t alignment);                 // Raw aligned storage, valid until release
 
 public:
-    static process *createProcess(int noOfPages, int noOfRAMPages); // Factory method
-    vector<vector<int>> runProcess();                              // Execute simulation with current algorithm
+    explicit arena(size_t blockSize = 64 * 1024);                  // Constructor, reserves the first block
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+    ~arena();                                                      // Releases every object
+
+    template <class T, class... Args>
+    T *create(Args &&...args) {                                    // Construct a T owned by the arena
+        T *object = new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+        if (!is_trivially_destructible<T>::value)
+            destructors.push_back({object, [](void *pointer) { static_cast<T *>(pointer)->~T(); }});
+        return object;
+    }
+    void release();                                                // Destroy all objects, keep the memory
 };
 
 // Abstract base class for RAM behavior simulation
@@ -100,21 +477,42 @@ class RAM {
 protected:
     int noOfRAMPages;                                              // Available RAM pages
     int noOfPages;                                                 // Total process pages
-    vector<int> pageID;                                            // Page reference sequence
+    traceView pageID;                                              // Page reference sequence (borrowed)
+
+public:
+    RAM(int noOfRAMPages, int noOfPages, traceView pageID);        // Constructor
+    virtual ~RAM() {}
+
+    virtual stats processRAM(int noOfPages, int noOfRAMPages, traceView pageID) = 0; // Pure virtual method
+};
+
+// Base class for algorithms that only look at past references. They can be fed a trace block by
+// block, which lets a single pass over the trace drive several algorithms at once.
+class onlineRAM : public RAM {
+protected:
+    int64_t missCount;                                             // Misses so far
+    int64_t total;                                                 // References processed so far
 
 public:
-    RAM(int noOfRAMPages, int noOfPages, vector<int> pageID);      // Constructor
+    onlineRAM(int noOfRAMPages, int noOfPages, traceView pageID);  // Constructor
 
-    virtual vector<int> processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) = 0; // Pure virtual method
+    stats processRAM(int noOfPages, int noOfRAMPages, traceView pageID) override; // Whole trace as one block
+    virtual void beginTrace();                                     // Start again from an empty RAM
+    virtual void processBlock(traceView block) = 0;                // Feed the next references of the trace
+    virtual stats endTrace();                                      // Counts of the trace
 };
 
 // Data structure to encapsulate algorithm creation function and identifier
 class algoData {
 public:
-    function<RAM *(int, int, vector<int>)> createFunction;         // Function to instantiate algorithm class
+    function<RAM *(arena &, int, int, traceView)> createFunction;  // Instantiates the algorithm class in an arena
     int algoID;                                                    // Unique identifier for algorithm
 
-    algoData(function<RAM *(int, int, vector<int>)> createFunction, int algoID); // Constructor
+    algoData(function<RAM *(arena &, int, int, traceView)> createFunction, int algoID); // Constructor
+
+    static bool selectEngine(const string &engineName);            // Make "<column>:<engine>" the active engine of its column
+    static vector<pair<string, algoData *>> selectedColumns();     // Active engine of every column chosen by --policies, by algoID
+    static int noOfColumns();                                      // Cells per result row, one per algoID and column 0
 };
 
 // Class to hold user inputs (singleton-like)
@@ -130,6 +528,7 @@ private:
 
 public:
     static void createHistory();                                   // Trigger history creation
+    static void createHistory(int noOfProcess, int RAMSize, int processSize); // History entry for given inputs
     int getRAMSize();                                              // Getter for RAM size
     int getNoOfProcess();                                          // Getter for number of processes
     int getProcessSize();                                          // Getter for process size
@@ -140,54 +539,400 @@ class output {
     output();                                                      // Private constructor
 
 public:
-    vector<vector<vector<int>>> mainOutput;                        // Aggregated simulation results
+    resultTable mainOutput;                                        // Aggregated simulation results, a row per page size
+
+    vector<perfSample> profile;                                    // [pageSize * columns + algoID], empty unless profiling
+    vector<missRatioCurve> LRUCurves;                              // LRU curve of every page size, empty unless --curve
+    vector<missRatioCurve> OPTCurves;                              // OPT curve of every page size, of no references unless OPT is selected
 
-    void mergeOutput(vector<vector<int>> curOutput);               // Merge result into main output
+    void mergeOutput(const resultTable &curOutput);                // Append the row of a configuration
+    void mergeProfile(const vector<perfSample> &curProfile);       // Append the costs of a configuration
     static output *getOutput();                                    // Singleton accessor
 };
 
+// Singleton holding command-line settings
+class config {
+    static config *currentInstance;                                // Singleton instance
+    config();                                                      // Private constructor
+
+public:
+    // One configuration of a batch: the three inputs and the options that apply to it alone
+    struct batchRun {
+        int noOfProcess;                                           // Number of processes
+        int RAMSize;                                               // Total RAM size
+        int processSize;                                           // Size of each process
+        vector<string> options;                                    // Overrides of the command-line settings
+        string description;                                        // The run as it was written
+    };
+
+    int noOfThreads;                                               // Worker threads used to simulate processes
+    bool fused;                                                    // Drive all algorithms of a process in one pass
+    bool streamed;                                                 // Generate traces in chunks instead of up front
+    string replayDirectory;                                        // Load process traces from here when present
+    string recordDirectory;                                        // Save every generated process trace here
+    uint64_t seed;                                                 // Seed of every generated trace in a run
+    string workloadSpec;                                           // Access pattern of generated traces
+    int sampleBudget;                                              // Pages sampled by the approximate curve engines
+    int gclockBits;                                                // Counter width of the GCLOCK engine
+    string checkpointPath;                                         // Record finished page sizes here and resume from it
+    string curvePath;                                              // Write the miss-ratio curve of every page size here
+    bool profiled;                                                 // Time every algorithm and read hardware counters
+    bool deduplicated;                                             // Share one simulation between configurations with equal page and frame counts
+    set<string> policies;                                          // Columns to simulate, every column when empty
+    vector<batchRun> runs;                                         // Configurations given by --run and --batch, in order
+
+    static config *getInstance();                                  // Singleton accessor
+    bool parseArguments(int argc, char *argv[]);                   // Apply command-line options, false on error
+    bool parseOptions(const vector<string> &options, bool commandLine); // Apply options, false on error
+    bool parseRun(const string &line);                             // Append a run written "processes RAM size [option]..."
+    bool loadBatch(const string &path);                            // Append a run for every line of a file
+    bool checkRuns();                                              // Apply every run to a copy, false if one is invalid
+    void applyRun(const batchRun &run);                            // Override the settings with the options of a run
+};
+
+// Work-stealing pool of worker threads shared by every parallel phase of a run.
+// Each worker owns a deque: it pops its own newest task first and steals the oldest task of another
+// worker when it runs dry, and only then starts the next root task. The calling thread takes part as
+// worker 0, so a pool of one thread runs everything inline. One run may be active at a time.
+class threadPool {
+    struct taskQueue {
+        mutex lock;                                                // Guards tasks
+        deque<function<void(int)>> tasks;                          // Owner works at the back, thieves at the front
+    };
+
+    static threadPool *currentInstance;                            // Singleton instance
+    static thread_local int currentWorker;                         // Worker index of the calling thread
+    vector<thread> workers;                                        // Background workers 1..noOfThreads-1
+    vector<unique_ptr<taskQueue>> queues;                          // Per-worker deques, index 0 is the caller
+    mutex lock;                                                    // Guards roots, stopping and taskGeneration updates
+    condition_variable wake;                                       // Signals new tasks, the end of a run or shutdown
+    deque<function<void(int)>> roots;                              // Root tasks of the current run in launch order
+    atomic<long long> pending;                                     // Tasks submitted but not yet finished
+    atomic<long long> taskGeneration;                              // Bumped whenever tasks become available
+    bool stopping;                                                 // Set when the pool shuts down
+
+    threadPool(int noOfThreads);                                   // Private constructor
+    void workerLoop(int worker);                                   // Body of a background worker
+    bool findTask(int worker, function<void(int)> &task);          // Own deque, then steal, then next root
+    void execute(int worker, function<void(int)> &task);           // Run a task and account for it
+
+public:
+    static threadPool *getInstance();                              // Singleton accessor, sized by config
+    ~threadPool();                                                 // Joins the workers
+
+    int size() const;                                              // Number of workers including the caller
+    void run(vector<function<void(int)>> rootTasks);               // Launch roots in order, wait for all spawned work
+    void spawn(function<void(int)> task);                          // Push a subtask onto the calling worker's deque
+};
+
 // FIFO (First-In-First-Out) page replacement algorithm
-class FIFO : public RAM {
+class FIFO : public onlineRAM {
+    unordered_set<int> cache;                                      // Resident pages
+    queue<int> order;                                              // Resident pages in load order
+
 public:
-    FIFO(int noOfRAMPages, int noOfPages, vector<int> pageID) : RAM(noOfRAMPages, noOfPages, pageID) {}
+    FIFO(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
 
-    vector<int> processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) override; // FIFO logic
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // FIFO logic
 };
 
 // LRU (Least Recently Used) page replacement algorithm
-class LRU : public RAM {
+class LRU : public onlineRAM {
+    set<pair<int64_t,int>> cache;                                  // (lastUsed, pageID), oldest first
+    unordered_map<int, int64_t> lastUsed;                          // Time of the latest reference per page
+
 public:
-    LRU(int noOfRAMPages, int noOfPages, vector<int> pageID) : RAM(noOfRAMPages, noOfPages, pageID) {}
+    LRU(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
 
-    vector<int> processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) override; // LRU logic
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // LRU logic
 };
 
 // MRU (Most Recently Used) page replacement algorithm
-class MRU : public RAM {
+class MRU : public onlineRAM {
+    set<pair<int64_t,int>> cache;                                  // (lastUsed, pageID), oldest first
+    unordered_map<int, int64_t> lastUsed;                          // Time of the latest reference per page
+
 public:
-    MRU(int noOfRAMPages, int noOfPages, vector<int> pageID) : RAM(noOfRAMPages, noOfPages, pageID) {}
+    MRU(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
 
-    vector<int> processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) override; // MRU logic
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // MRU logic
 };
 
 // OPT (Optimal) page replacement algorithm (requires future knowledge)
 class OPT : public RAM {
 public:
-    OPT(int noOfRAMPages, int noOfPages, vector<int> pageID) : RAM(noOfRAMPages, noOfPages, pageID) {}
+    OPT(int noOfRAMPages, int noOfPages, traceView pageID) : RAM(noOfRAMPages, noOfPages, pageID) {}
+
+    stats processRAM(int noOfPages, int noOfRAMPages, traceView pageID) override; // Optimal logic
+
+    static traceView denseView(traceView pageID, vector<int> &storage); // Same trace with ids in [1, width]
+    static vector<size_t> nextOccurrence(traceView pageID);        // Index of each reference's next use, size() if none
+    static vector<size_t> nextOccurrenceByMap(traceView pageID);   // Tree-based reference version of nextOccurrence
+};
+
+// OPT with resident pages in a flat max-heap keyed by next use. A hit pushes a fresh entry and
+// leaves the old one behind; stale entries are skipped when they surface and swept out whenever
+// they outnumber the frames. Residency lives in a flat array indexed by page id.
+class OPTHeap : public RAM {
+public:
+    OPTHeap(int noOfRAMPages, int noOfPages, traceView pageID) : RAM(noOfRAMPages, noOfPages, pageID) {}
+
+    stats processRAM(int noOfPages, int noOfRAMPages, traceView pageID) override; // Heap-based optimal logic
+};
+
+// Incremental Mattson stack-distance counter over a stream of references
+class stackDistance {
+    int capacity;                                                  // Access-time slots before a compaction
+    vector<int> fenwick;                                           // Marks the latest access time of every page
+    vector<int> pageAt;                                            // Page accessed at each time slot
+    vector<int> lastTime;                                          // Latest access time per page, -1 if never seen
+    vector<long long> distanceCount;                               // References seen at each stack distance
+    int nextTime;                                                  // Next free time slot
+    int active;                                                    // Distinct pages seen so far
+    long long total;                                               // References seen so far
+
+    void add(int pos, int delta);                                  // Fenwick point update
+    int prefix(int pos) const;                                     // Fenwick prefix sum over [0, pos]
+    void compact();                                                // Renumber live access times from 0
+
+public:
+    stackDistance(int pageIDWidth = 0, int maxActive = 0);         // Ids in [1, pageIDWidth], at most maxActive on the stack (0: all)
+
+    int reference(int id);                                         // Move id to the top, returns its stack distance (0 if new)
+    void remove(int id);                                           // Drop id from the stack
+    void processBlock(traceView block);                            // Account for the next references
+    missRatioCurve getCurve() const;                               // Curve of everything seen so far
+};
+
+// Approximate stack distances from a spatially hashed sample of the pages (SHARDS, Waldspurger et al.).
+// A page is sampled when the hash of its id is below a threshold, so every reference to it is kept
+// and its distances stay exact within the sample; scaling them by the sampling rate estimates the
+// distances in the full trace. The threshold starts at the full range and is lowered to evict the
+// page with the largest hash whenever more than sampleBudget pages are sampled. That bounds the
+// sampled set, and with it the work per reference and the Fenwick tree of access times; the last-use,
+// distance and weight arrays are still indexed by page id or distance, O(pageIDWidth). Traces with
+// at most sampleBudget pages are exact.
+class sampledStackDistance {
+    stackDistance counter;                                         // Exact distances within the sample
+    int sampleBudget;                                              // Most pages sampled at once
+    int sampledPages;                                              // Pages currently sampled
+    uint64_t threshold;                                            // Pages whose hash is below this are sampled
+    priority_queue<pair<uint32_t, int>> largestHash;               // Sampled pages by hash, largest first
+    vector<double> weightAt;                                       // Reuses at each scaled distance, weighted by 1 / rate
+    double sampledWeight;                                          // Sampled references, weighted by 1 / rate
+    long long total;                                               // References seen so far, sampled or not
+
+public:
+    sampledStackDistance(int pageIDWidth, int sampleBudget);       // Constructor
+
+    void processBlock(traceView block);                            // Account for the next references
+    missRatioCurve getCurve() const;                               // Estimated curve of everything seen so far
+};
+
+// LRU evaluated through its miss-ratio curve instead of simulating a single frame count
+class LRUStack : public onlineRAM {
+    stackDistance counter;                                         // Stack distances of the trace so far
+
+public:
+    LRUStack(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
+
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // Stack-distance LRU logic
+    stats endTrace() override;
+};
+
+// LRU estimated from a sampled miss-ratio curve; the sample size comes from --sample-budget
+class LRUSampled : public onlineRAM {
+    unique_ptr<sampledStackDistance> counter;                      // Sampled stack distances of the trace so far
+
+public:
+    LRUSampled(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
+
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // Sampled stack-distance LRU logic
+    stats endTrace() override;
+};
+
+// Doubly linked list of resident pages held in flat arrays indexed by page id (slot 0 is the sentinel).
+// Requires dense ids in [1, pageIDWidth]; every operation is O(1) and nothing is allocated after construction.
+class pageList {
+    vector<int> prev;                                              // Previous page towards the front, -1 if not listed
+    vector<int> next;                                              // Next page towards the back
+    int count;                                                     // Number of listed pages
+
+public:
+    pageList(int pageIDWidth = 0);                                 // Empty list able to hold ids 1..pageIDWidth
+
+    bool contains(int id) const;                                   // Is the page listed
+    int size() const;                                              // Number of listed pages
+    int front() const;                                             // Most recently pushed page
+    int back() const;                                              // Least recently pushed page
+    void pushFront(int id);                                        // List a page at the front
+    void remove(int id);                                           // Unlist a page
+};
+
+// LRU over a flat-array page list: hits move to the front, the back is evicted
+class LRUList : public onlineRAM {
+    pageList cache;                                                // Resident pages, most recent first
+
+public:
+    LRUList(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
+
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // O(1) LRU logic
+};
+
+// MRU over a flat-array page list: hits move to the front, the front is evicted
+class MRUList : public onlineRAM {
+    pageList cache;                                                // Resident pages, most recent first
+
+public:
+    MRUList(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
+
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // O(1) MRU logic
+};
+
+// FIFO over a residency bitmap indexed by page id and a ring of noOfRAMPages frames in load order.
+// A hit is one bit test; a miss overwrites the oldest frame. Requires dense ids in [1, pageIDWidth].
+class FIFORing : public onlineRAM {
+    vector<uint64_t> resident;                                     // Bit per page id, set while resident
+    vector<int> ring;                                              // Resident pages, oldest at nextFrame once full
+    int nextFrame;                                                 // Frame the next loaded page goes to
+    int loaded;                                                    // Frames in use
+
+public:
+    FIFORing(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
+
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // Bitmap and ring FIFO logic
+};
+
+// CLOCK: the frames form a circle swept by a hand. A hit sets the reference bit of its frame, and a
+// miss advances the hand, clearing set bits, to the first frame whose bit is clear and replaces its
+// page. Bits are packed 64 to a word, so the hand clears a run of referenced frames a word at a
+// time. Plain CLOCK loads a page with its bit set, as the access that faults it in sets it; second
+// chance loads it clear, so only a later hit earns a page its second chance.
+class CLOCK : public onlineRAM {
+    bool loadReferenced;                                           // Pages enter with their reference bit set
+    vector<int> frames;                                            // Page in each frame
+    vector<int> frameOf;                                           // Frame of each page, -1 if not resident
+    vector<uint64_t> referenced;                                   // Reference bit per frame
+    int hand;                                                      // Next frame the hand inspects
+    int loaded;                                                    // Frames in use
+
+    int findVictim();                                              // Sweep to the first unreferenced frame
+
+public:
+    CLOCK(int noOfRAMPages, int noOfPages, traceView pageID, bool loadReferenced = true)
+        : onlineRAM(noOfRAMPages, noOfPages, pageID), loadReferenced(loadReferenced) {}
+
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // Packed reference bit CLOCK logic
+};
+
+// Generalized CLOCK: each frame holds a saturating counter of --gclock-bits bits instead of a single
+// bit. A page enters with count 1 and every hit adds 1; the hand decrements counts as it passes and
+// replaces the first page it finds at 0, so frequently used pages survive several sweeps. Counters
+// are packed into 64-bit words; one bit behaves like plain CLOCK.
+class GCLOCK : public onlineRAM {
+    int counterBits;                                               // Width of each counter (1, 2, 4 or 8)
+    vector<int> frames;                                            // Page in each frame
+    vector<int> frameOf;                                           // Frame of each page, -1 if not resident
+    vector<uint64_t> counters;                                     // counterBits per frame
+    int hand;                                                      // Next frame the hand inspects
+    int loaded;                                                    // Frames in use
+
+    int getCount(int frame) const;                                 // Counter of a frame
+    void setCount(int frame, int count);                           // Overwrite the counter of a frame
+
+public:
+    GCLOCK(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
+
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // Packed counter GCLOCK logic
+};
+
+// Adaptive Replacement Cache (Megiddo and Modha): resident pages are split between T1, seen once
+// since they were loaded, and T2, seen at least twice, while the ghost lists B1 and B2 remember the
+// ids recently evicted from each. A miss on a ghost moves the target size of T1 towards the side it
+// came from, so the split between recency and frequency follows the trace. A page is on at most one
+// of the four lists, so they share one set of links indexed by page id, and the list each id is on
+// is the ghost directory. Requires dense ids in [1, pageIDWidth]; nothing is allocated after beginTrace.
+class ARC : public onlineRAM {
+    enum { NONE, T1, T2, B1, B2 };                                 // List a page is on
+
+    vector<int> prev;                                              // Page towards the most recent end; slot sentinel + list heads a list
+    vector<int> next;                                              // Page towards the least recent end
+    vector<uint8_t> listOf;                                        // List of each page id, NONE if on none
+    int length[5];                                                 // Pages on each list
+    int sentinel;                                                  // Offset of the list heads in prev and next
+    int target;                                                    // Adaptive target size of T1
+
+    int back(int list) const;                                      // Least recent page of a list
+    void pushFront(int list, int id);                              // Make a page the most recent of a list
+    void remove(int id);                                           // Take a page off its list
+    void replace(bool ghostOfT2);                                  // Evict the least recent page of T1 or T2 to its ghost list
+
+public:
+    ARC(int noOfRAMPages, int noOfPages, traceView pageID) : onlineRAM(noOfRAMPages, noOfPages, pageID) {}
+
+    void beginTrace() override;
+    void processBlock(traceView block) override;                   // Adaptive replacement logic
+};
+
+// OPT evaluated through its miss-ratio curve instead of simulating a single frame count
+class OPTStack : public RAM {
+public:
+    OPTStack(int noOfRAMPages, int noOfPages, traceView pageID) : RAM(noOfRAMPages, noOfPages, pageID) {}
 
-    vector<int> processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) override; // Optimal logic
+    stats processRAM(int noOfPages, int noOfRAMPages, traceView pageID) override; // Priority-stack optimal logic
 };
 
+// Every available engine, keyed "<column>:<engine>"; algoID names the result column it fills
+unordered_map<string, algoData *> engines = {
+    {"OPT:set", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                             { return memory.create<OPT>(noOfRAMPages, noOfPages, pageID); }, 1)},
+    {"OPT:heap", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                              { return memory.create<OPTHeap>(noOfRAMPages, noOfPages, pageID); }, 1)},
+    {"OPT:stack", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                               { return memory.create<OPTStack>(noOfRAMPages, noOfPages, pageID); }, 1)},
+    {"FIFO:queue", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                                { return memory.create<FIFO>(noOfRAMPages, noOfPages, pageID); }, 2)},
+    {"FIFO:ring", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                               { return memory.create<FIFORing>(noOfRAMPages, noOfPages, pageID); }, 2)},
+    {"LRU:set", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                             { return memory.create<LRU>(noOfRAMPages, noOfPages, pageID); }, 3)},
+    {"LRU:stack", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                               { return memory.create<LRUStack>(noOfRAMPages, noOfPages, pageID); }, 3)},
+    {"LRU:shards", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                                { return memory.create<LRUSampled>(noOfRAMPages, noOfPages, pageID); }, 3)},
+    {"LRU:list", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                              { return memory.create<LRUList>(noOfRAMPages, noOfPages, pageID); }, 3)},
+    {"MRU:set", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                             { return memory.create<MRU>(noOfRAMPages, noOfPages, pageID); }, 4)},
+    {"MRU:list", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                              { return memory.create<MRUList>(noOfRAMPages, noOfPages, pageID); }, 4)},
+    {"CLOCK:clock", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                                 { return memory.create<CLOCK>(noOfRAMPages, noOfPages, pageID, true); }, 5)},
+    {"CLOCK:second-chance", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                                         { return memory.create<CLOCK>(noOfRAMPages, noOfPages, pageID, false); }, 5)},
+    {"CLOCK:gclock", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                                  { return memory.create<GCLOCK>(noOfRAMPages, noOfPages, pageID); }, 5)},
+    {"ARC:list", new algoData([](arena &memory, int noOfRAMPages, int noOfPages, traceView pageID)
+                              { return memory.create<ARC>(noOfRAMPages, noOfPages, pageID); }, 6)}};
+
 // Mapping algorithm names to their corresponding factory functions and unique identifiers
 unordered_map<string, algoData *> mapping = {
-    {"OPT", new algoData([](int noOfRAMPages, int noOfPages, vector<int> pageID)
-                         { return new OPT(noOfRAMPages, noOfPages, pageID); }, 1)},
-    {"FIFO", new algoData([](int noOfRAMPages, int noOfPages, vector<int> pageID)
-                          { return new FIFO(noOfRAMPages, noOfPages, pageID); }, 2)},
-    {"LRU", new algoData([](int noOfRAMPages, int noOfPages, vector<int> pageID)
-                         { return new LRU(noOfRAMPages, noOfPages, pageID); }, 3)},
-    {"MRU", new algoData([](int noOfRAMPages, int noOfPages, vector<int> pageID)
-                         { return new MRU(noOfRAMPages, noOfPages, pageID); }, 4)}};
+    {"OPT", engines["OPT:heap"]},
+    {"FIFO", engines["FIFO:ring"]},
+    {"LRU", engines["LRU:list"]},
+    {"MRU", engines["MRU:list"]},
+    {"CLOCK", engines["CLOCK:clock"]},
+    {"ARC", engines["ARC:list"]}};
 
 // ------------------------------
 // Definition: history class
@@ -198,25 +943,107 @@ void history::printCurrentStats() {
     input *currInput = hist.back().first;
     output *currOutput = hist.back().second;
 
-    int noOfRows = currOutput->mainOutput.size();
-    int noOfColumns = mapping.size() + 1;
+    int noOfRows = currOutput->mainOutput.getRows();
+    vector<pair<string, algoData *>> columns = algoData::selectedColumns();
+    int noOfColumns = columns.size() + 1;
 
     vector<vector<string>> table(noOfRows, vector<string>(noOfColumns));
-    cout << "Results:" << endl;
 
     table[0][0] = "Page Size";
     for (int i = 1; i < noOfRows; i++) {
         table[i][0] = to_string(i);
     }
 
-    for (auto it : mapping) {
-        table[0][it.second->algoID] = it.first + "(Hit Rate)";
+    for (int j = 1; j < noOfColumns; j++) {
+        table[0][j] = columns[j - 1].first + "(Hit Rate)";
         for (int i = 1; i < noOfRows; i++) {
-            int total = currOutput->mainOutput[i][it.second->algoID][TOTAL];
-            int miss = currOutput->mainOutput[i][it.second->algoID][MISS];
-            table[i][it.second->algoID] = to_string(1.0 * (total - miss) / total);
+            stats counts = currOutput->mainOutput.get(i, columns[j - 1].second->algoID);
+            table[i][j] = to_string(1.0 * (counts.total - counts.missCount) / counts.total);
         }
     }
+    printTable("Results:", table);
+}
+
+// One table per metric, laid out like the results. Cells of page sizes restored from a checkpoint,
+// or that report the counts of another page size under --dedupe, have no cost and show '-'; tables
+// of counters that never counted are left out.
+void history::printProfile() {
+    output *currOutput = hist.back().second;
+    int noOfRows = currOutput->mainOutput.getRows();
+    int noOfCells = algoData::noOfColumns();
+    if (currOutput->profile.size() != (size_t)noOfRows * noOfCells)
+        return;
+    vector<pair<string, algoData *>> columns = algoData::selectedColumns();
+    int noOfColumns = columns.size() + 1;
+
+    struct metric {
+        string title;                                              // Table title
+        function<double(const perfSample &, int64_t)> value;       // Value of a cell from its cost and reference count
+        bool counted;                                              // The counter behind it ever ran
+    };
+    bool cycles = false, instructions = false, cacheMisses = false, branchMisses = false;
+    for (const perfSample &sample : currOutput->profile) {
+        cycles |= sample.cycles > 0;
+        instructions |= sample.instructions > 0;
+        cacheMisses |= sample.cacheMisses > 0;
+        branchMisses |= sample.branchMisses > 0;
+    }
+    vector<metric> metrics = {
+        {"Time (ns per reference):", [](const perfSample &cost, int64_t total) { return 1.0 * cost.nanoseconds / total; }, true},
+        {"Cycles per reference:", [](const perfSample &cost, int64_t total) { return 1.0 * cost.cycles / total; }, cycles},
+        {"Instructions per cycle:", [](const perfSample &cost, int64_t) { return 1.0 * cost.instructions / max<int64_t>(cost.cycles, 1); }, cycles && instructions},
+        {"LLC misses per 1000 references:", [](const perfSample &cost, int64_t total) { return 1000.0 * cost.cacheMisses / total; }, cacheMisses},
+        {"Branch misses per 1000 references:", [](const perfSample &cost, int64_t total) { return 1000.0 * cost.branchMisses / total; }, branchMisses}};
+    if (!cycles)
+        cout << "Hardware counters unavailable, timing only" << endl;
+
+    for (const metric &curMetric : metrics) {
+        if (!curMetric.counted)
+            continue;
+        vector<vector<string>> table(noOfRows, vector<string>(noOfColumns));
+        table[0][0] = "Page Size";
+        for (int i = 1; i < noOfRows; i++)
+            table[i][0] = to_string(i);
+        for (int j = 1; j < noOfColumns; j++) {
+            int algoID = columns[j - 1].second->algoID;
+            table[0][j] = columns[j - 1].first;
+            for (int i = 1; i < noOfRows; i++) {
+                const perfSample &cost = currOutput->profile[(size_t)i * noOfCells + algoID];
+                int64_t total = currOutput->mainOutput.get(i, algoID).total;
+                table[i][j] = (cost.nanoseconds > 0 && total > 0) ? to_string(curMetric.value(cost, total)) : "-";
+            }
+        }
+        printTable(curMetric.title, table);
+    }
+}
+
+// One line per page size and frame count, from one frame up to every page of the process, with an
+// OPT column when OPT is selected. Page sizes restored from a checkpoint were not simulated and have
+// no curve.
+bool history::saveCurves(const string &path) {
+    output *currOutput = hist.back().second;
+    const set<string> &policies = config::getInstance()->policies;
+    bool optimal = policies.empty() || policies.count("OPT") > 0;
+    ofstream file(path);
+    file << "pageSize,frames,references,LRU hits" << (optimal ? ",OPT hits" : "") << "\n";
+    for (size_t pageSize = 1; pageSize < currOutput->LRUCurves.size(); pageSize++) {
+        const missRatioCurve &curve = currOutput->LRUCurves[pageSize];
+        const missRatioCurve &optimalCurve = currOutput->OPTCurves[pageSize];
+        for (int frames = 1; curve.getTotal() > 0 && frames <= curve.getMaxFrames(); frames++) {
+            file << pageSize << "," << frames << "," << curve.getTotal() << "," << curve.getTotal() - curve.getMissCount(frames);
+            if (optimal)
+                file << "," << optimalCurve.getTotal() - optimalCurve.getMissCount(frames);
+            file << "\n";
+        }
+    }
+    file.close();
+    return !file.fail();
+}
+
+void history::printTable(const string &title, vector<vector<string>> table) {
+    int noOfRows = table.size();
+    int noOfColumns = table[0].size();
+    cout << title << endl;
 
     // Padding cells for alignment
     for (int j = 0; j < noOfColumns; j++) {
@@ -274,8 +1101,49 @@ output *output::getOutput() {
     return new output();
 }
 
-void output::mergeOutput(vector<vector<int>> curOutput) {
-    this->mainOutput.push_back(curOutput);
+void output::mergeOutput(const resultTable &curOutput) {
+    this->mainOutput.appendRow(curOutput, 0);
+}
+
+void output::mergeProfile(const vector<perfSample> &curProfile) {
+    this->profile.insert(this->profile.end(), curProfile.begin(), curProfile.end());
+}
+
+// ------------------------------
+// Definition: resultTable class
+// ------------------------------
+resultTable::resultTable(int noOfRows, int noOfColumns) {
+    this->noOfColumns = noOfColumns;
+    this->missCount.assign((size_t)noOfRows * noOfColumns, 0);
+    this->total.assign((size_t)noOfRows * noOfColumns, 0);
+}
+
+int resultTable::getRows() const { return noOfColumns == 0 ? 0 : missCount.size() / noOfColumns; }
+int resultTable::getColumns() const { return noOfColumns; }
+
+stats resultTable::get(int row, int column) const {
+    size_t cell = (size_t)row * noOfColumns + column;
+    return {missCount[cell], total[cell]};
+}
+
+void resultTable::add(int row, int column, stats counts) {
+    size_t cell = (size_t)row * noOfColumns + column;
+    missCount[cell] += counts.missCount;
+    total[cell] += counts.total;
+}
+
+void resultTable::addRow(int row, const resultTable &source, int sourceRow) {
+    for (int column = 0; column < noOfColumns && column < source.noOfColumns; column++)
+        add(row, column, source.get(sourceRow, column));
+}
+
+// An empty table takes the width of the first row appended to it
+void resultTable::appendRow(const resultTable &source, int sourceRow) {
+    if (missCount.empty())
+        noOfColumns = source.noOfColumns;
+    missCount.resize(missCount.size() + noOfColumns, 0);
+    total.resize(total.size() + noOfColumns, 0);
+    addRow(getRows() - 1, source, sourceRow);
 }
 
 // ------------------------------
@@ -306,134 +1174,1770 @@ void input::createHistory() {
     history::getInstance()->updateHistory(in, out);
 }
 
+void input::createHistory(int noOfProcess, int RAMSize, int processSize) {
+    input *in = new input(RAMSize, noOfProcess, processSize);
+    output *out = output::getOutput();
+    history::getInstance()->updateHistory(in, out);
+}
+
 int input::getRAMSize() { return RAMSize; }
 int input::getNoOfProcess() { return noOfProcess; }
 int input::getProcessSize() { return processSize; }
 
 // ------------------------------
-// Definition: handler class
+// Definition: config class
 // ------------------------------
-handler::handler(int RAMSize, int noOfProcess, int processSize) {
-    this->RAMSize = RAMSize;
-    this->noOfProcess = noOfProcess;
-    this->processSize = processSize;
-}
-
-handler *handler::createHandler() {
-    history *instance = history::getInstance();
-    input::createHistory();
-    input *curInput = instance->getLastElement().first;
-    return new handler(curInput->getRAMSize(), curInput->getNoOfProcess(), curInput->getProcessSize());
+config *config::currentInstance = NULL;
+
+config::config() {
+    this->noOfThreads = 1;
+    this->fused = true;
+    this->streamed = false;
+    this->seed = 1;
+    this->workloadSpec = "uniform";
+    this->sampleBudget = 8192;
+    this->gclockBits = 2;
+    this->profiled = false;
+    this->deduplicated = false;
 }
 
-void handler::analyzeOnAllPageSize() {
-    for (int curPageSize = 0; curPageSize <= min(RAMSize, processSize); curPageSize++) {
-        analyze *curAnalyze = analyze::createAnalyze(noOfProcess, RAMSize, processSize, curPageSize);
-        curAnalyze->runProcesses();
-    }
+config *config::getInstance() {
+    if (currentInstance == NULL)
+        currentInstance = new config();
+    return currentInstance;
 }
 
-void handler::printAnalyzedData() {
-    history::getInstance()->printCurrentStats();
+bool config::parseArguments(int argc, char *argv[]) {
+    if (!parseOptions(vector<string>(argv + 1, argv + argc), true))
+        return false;
+    return checkRuns();
 }
 
-// ------------------------------
-// Definition: analyze class
-// ------------------------------
-analyze::analyze(int noOfProcess, int noOfPages, int noOfRAMPages) {
-    this->noOfProcess = noOfProcess;
-    this->noOfPages = noOfPages;
-    this->noOfRAMPages = noOfRAMPages;
+// Options of a batch run are parsed like the command line, except for those that shape the whole
+// process: the pool is shared by every run and runs cannot add runs.
+bool config::parseOptions(const vector<string> &options, bool commandLine) {
+    int argc = options.size();
+    for (int i = 0; i < argc; i++) {
+        const string &option = options[i];
+        if ((option == "--threads" || option == "--run" || option == "--batch") && !commandLine) {
+            cerr << option << " is only accepted on the command line" << endl;
+            return false;
+        } else if (option == "--threads" && i + 1 < argc) {
+            noOfThreads = atoi(options[++i].c_str());
+            if (noOfThreads <= 0)
+                noOfThreads = max(1u, thread::hardware_concurrency());
+        } else if (option == "--run" && i + 1 < argc) {
+            if (!parseRun(options[++i]))
+                return false;
+        } else if (option == "--batch" && i + 1 < argc) {
+            if (!loadBatch(options[++i]))
+                return false;
+        } else if (option == "--dedupe") {
+            deduplicated = true;
+        } else if (option == "--profile") {
+            profiled = true;
+        } else if (option == "--unfused") {
+            fused = false;
+        } else if (option == "--stream") {
+            streamed = true;
+        } else if (option == "--replay" && i + 1 < argc) {
+            replayDirectory = options[++i];
+        } else if (option == "--record" && i + 1 < argc) {
+            recordDirectory = options[++i];
+        } else if (option == "--seed" && i + 1 < argc) {
+            seed = strtoull(options[++i].c_str(), NULL, 10);
+        } else if (option == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = options[++i];
+        } else if (option == "--curve" && i + 1 < argc) {
+            curvePath = options[++i];
+        } else if (option == "--gclock-bits" && i + 1 < argc) {
+            gclockBits = atoi(options[++i].c_str());
+            if (gclockBits != 1 && gclockBits != 2 && gclockBits != 4 && gclockBits != 8) {
+                cerr << "GCLOCK counters must be 1, 2, 4 or 8 bits wide" << endl;
+                return false;
+            }
+        } else if (option == "--sample-budget" && i + 1 < argc) {
+            sampleBudget = max(1, atoi(options[++i].c_str()));
+        } else if (option == "--workload" && i + 1 < argc) {
+            workloadSpec = options[++i];
+            if (!unique_ptr<workload>(workload::createWorkload(workloadSpec, 1))) {
+                cerr << "Invalid workload: " << workloadSpec << endl;
+                return false;
+            }
+        } else if (option == "--policies" && i + 1 < argc) {
+            stringstream names(options[++i]);
+            string name;
+            policies.clear();
+            while (getline(names, name, ','))
+                if (!name.empty())
+                    policies.insert(name);
+            for (const string &policy : policies) {
+                if (mapping.count(policy) == 0) {
+                    cerr << "Unknown policy: " << policy << endl;
+                    return false;
+                }
+            }
+            if (policies.empty()) {
+                cerr << "No policy selected" << endl;
+                return false;
+            }
+        } else if (option == "--engine" && i + 1 < argc) {
+            string engineName = options[++i];
+            if (!algoData::selectEngine(engineName)) {
+                cerr << "Unknown engine: " << engineName << endl;
+                return false;
+            }
+        } else {
+            cerr << "Unknown option: " << option << endl;
+            cerr << "Usage: PageReplacementAnalyzer [--threads N] [--unfused] [--stream] [--profile] [--dedupe] [--replay DIR] [--record DIR] [--seed N]"
+                 << " [--workload SPEC] [--sample-budget N] [--gclock-bits N] [--checkpoint FILE] [--curve FILE]"
+                 << " [--policies COLUMN,...] [--engine <column>:<engine>]... [--run \"PROCESSES RAM SIZE [option]...\"]... [--batch FILE]" << endl;
+            return false;
+        }
+    }
+    return true;
 }
 
-analyze *analyze::createAnalyze(int noOfProcess, int RAMSize, int processSize, int pageSize) {
-    int noOfPages = (pageSize == 0) ? -1 : ((processSize + pageSize - 1) / pageSize);
-    int noOfRAMPages = (pageSize == 0) ? -1 : (RAMSize / pageSize);
-    return new analyze(noOfProcess, noOfPages, noOfRAMPages);
+bool config::parseRun(const string &line) {
+    stringstream fields(line);
+    batchRun run;
+    if (!(fields >> run.noOfProcess >> run.RAMSize >> run.processSize) ||
+        run.noOfProcess <= 0 || run.RAMSize <= 0 || run.processSize <= 0) {
+        cerr << "Invalid run: " << line << endl;
+        return false;
+    }
+    string option;
+    while (fields >> option)
+        run.options.push_back(option);
+    run.description = line;
+    runs.push_back(run);
+    return true;
 }
 
-void analyze::runProcesses() {
-    for (int i = 0; i < noOfProcess; i++) {
-        process *curProcess = process::createProcess(noOfPages, noOfRAMPages);
-        vector<vector<int>> curOutput = curProcess->runProcess();
-        mergeOutput(curOutput);
+// One run per line; blank lines and lines starting with '#' are skipped
+bool config::loadBatch(const string &path) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        cerr << "Cannot open batch file: " << path << endl;
+        return false;
     }
-
-    output *mainOutput = history::getInstance()->getLastElement().second;
-    mainOutput->mergeOutput(this->curOutput);
+    string line;
+    while (getline(file, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#')
+            continue;
+        line = line.substr(first, line.find_last_not_of(" \t\r") + 1 - first);
+        if (!parseRun(line))
+            return false;
+    }
+    return true;
 }
 
-void analyze::mergeOutput(vector<vector<int>> curOutput) {
-    for (int i = 0; i < curOutput.size(); i++) {
-        if (this->curOutput.size() > i) {
-            this->curOutput[i][TOTAL] += curOutput[i][TOTAL];
-            this->curOutput[i][MISS] += curOutput[i][MISS];
-        } else {
-            this->curOutput.push_back(curOutput[i]);
+// Every run is tried on a copy of the settings before the first one starts, so a typo on the last
+// line of a batch does not surface hours into it. Two runs may not share a checkpoint, since each
+// checkpoint belongs to one run, nor a curve file, which each run overwrites.
+bool config::checkRuns() {
+    set<string> checkpointPaths, curvePaths;
+    for (const batchRun &run : runs) {
+        unordered_map<string, algoData *> savedMapping = mapping;
+        config trial = *this;
+        bool valid = trial.parseOptions(run.options, false);
+        mapping = savedMapping;
+        if (!valid) {
+            cerr << "Invalid run: " << run.description << endl;
+            return false;
+        }
+        if (!trial.checkpointPath.empty() && !checkpointPaths.insert(trial.checkpointPath).second) {
+            cerr << "Runs share the checkpoint " << trial.checkpointPath << endl;
+            return false;
+        }
+        if (!trial.curvePath.empty() && !curvePaths.insert(trial.curvePath).second) {
+            cerr << "Runs share the curve file " << trial.curvePath << endl;
+            return false;
         }
     }
+    return true;
+}
+
+void config::applyRun(const batchRun &run) {
+    parseOptions(run.options, false);
 }
 
 // ------------------------------
-// Definition: process class
+// Definition: threadPool class
 // ------------------------------
-process::process(int noOfPages, int noOfRAMPages, vector<int> pageID) {
-    this->noOfPages = noOfPages;
-    this->noOfRAMPages = noOfRAMPages;
-    this->pageID = pageID;
+threadPool *threadPool::currentInstance = NULL;
+thread_local int threadPool::currentWorker = 0;
+
+threadPool::threadPool(int noOfThreads) {
+    this->pending = 0;
+    this->taskGeneration = 0;
+    this->stopping = false;
+    for (int worker = 0; worker < noOfThreads; worker++)
+        queues.emplace_back(new taskQueue());
+    for (int worker = 1; worker < noOfThreads; worker++)
+        workers.emplace_back(&threadPool::workerLoop, this, worker);
 }
 
-process *process::createProcess(int noOfPages, int noOfRAMPages) {
-    vector<int> pageID;
-    int noOfBlocks = 100 * noOfPages;
+threadPool *threadPool::getInstance() {
+    if (currentInstance == NULL)
+        currentInstance = new threadPool(config::getInstance()->noOfThreads);
+    return currentInstance;
+}
 
-    for (int i = 0; i < noOfBlocks; i++) {
-        int pid = (rand() % noOfPages) + 1;
-        pageID.push_back(pid);
+threadPool::~threadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
     }
+    wake.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
 
-    return new process(noOfPages, noOfRAMPages, pageID);
+int threadPool::size() const {
+    return queues.size();
 }
 
-vector<vector<int>> process::runProcess() {
-    vector<vector<int>> processOutput(mapping.size() + 1, vector<int>(2, -1));
-    for (auto it : mapping) {
-        if (noOfPages == -1) {
-            processOutput[it.second->algoID] = {-1, -1};
-            continue;
+bool threadPool::findTask(int worker, function<void(int)> &task) {
+    {
+        taskQueue &own = *queues[worker];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (int offset = 1; offset < (int)queues.size(); offset++) {
+        taskQueue &victim = *queues[(worker + offset) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
         }
-        RAM *algoInstance = it.second->createFunction(noOfPages, noOfRAMPages, pageID);
-        processOutput[it.second->algoID] = algoInstance->processRAM(noOfPages, noOfRAMPages, pageID);
     }
-    return processOutput;
+    lock_guard<mutex> guard(lock);
+    if (roots.empty())
+        return false;
+    task = move(roots.front());
+    roots.pop_front();
+    return true;
 }
 
-// ------------------------------
-// Definition: RAM class
-// ------------------------------
-RAM::RAM(int noOfRAMPages, int noOfPages, vector<int> pageID) {
+void threadPool::execute(int worker, function<void(int)> &task) {
+    task(worker);
+    if (--pending == 0) {
+        lock_guard<mutex> guard(lock);
+        wake.notify_all();
+    }
+}
+
+void threadPool::workerLoop(int worker) {
+    currentWorker = worker;
+    function<void(int)> task;
+    while (true) {
+        long long seenGeneration = taskGeneration;
+        if (findTask(worker, task)) {
+            execute(worker, task);
+            continue;
+        }
+        unique_lock<mutex> guard(lock);
+        wake.wait(guard, [&] { return stopping || taskGeneration != seenGeneration; });
+        if (stopping)
+            return;
+    }
+}
+
+void threadPool::spawn(function<void(int)> task) {
+    pending++;
+    {
+        taskQueue &own = *queues[currentWorker];
+        lock_guard<mutex> guard(own.lock);
+        own.tasks.push_back(move(task));
+    }
+    lock_guard<mutex> guard(lock);
+    taskGeneration++;
+    wake.notify_all();
+}
+
+void threadPool::run(vector<function<void(int)>> rootTasks) {
+    if (rootTasks.empty())
+        return;
+    pending += rootTasks.size();
+    {
+        lock_guard<mutex> guard(lock);
+        for (auto &task : rootTasks)
+            roots.push_back(move(task));
+        taskGeneration++;
+    }
+    wake.notify_all();
+
+    function<void(int)> task;
+    while (true) {
+        long long seenGeneration = taskGeneration;
+        if (findTask(0, task)) {
+            execute(0, task);
+            continue;
+        }
+        unique_lock<mutex> guard(lock);
+        wake.wait(guard, [&] { return pending == 0 || taskGeneration != seenGeneration; });
+        if (pending == 0)
+            return;
+    }
+}
+
+// ------------------------------
+// Definition: handler class
+// ------------------------------
+handler::handler(int RAMSize, int noOfProcess, int processSize) {
+    this->RAMSize = RAMSize;
+    this->noOfProcess = noOfProcess;
+    this->processSize = processSize;
+}
+
+handler *handler::createHandler() {
+    history *instance = history::getInstance();
+    input::createHistory();
+    input *curInput = instance->getLastElement().first;
+    return new handler(curInput->getRAMSize(), curInput->getNoOfProcess(), curInput->getProcessSize());
+}
+
+handler *handler::createHandler(int noOfProcess, int RAMSize, int processSize) {
+    input::createHistory(noOfProcess, RAMSize, processSize);
+    return new handler(RAMSize, noOfProcess, processSize);
+}
+
+// Every configuration of the sweep lives in one arena and is released together once the results
+// have been published to the history; the arena keeps its memory for the next sweep of a batch.
+// With a checkpoint, page sizes it already holds are restored instead of simulated, and every page
+// size finished now is added to it.
+bool handler::analyzeOnAllPageSize() {
+    unique_ptr<checkpoint> progress;
+    map<int, resultTable> savedOutput;
+    const string &checkpointPath = config::getInstance()->checkpointPath;
+    if (!checkpointPath.empty()) {
+        progress.reset(checkpoint::openCheckpoint(checkpointPath, RAMSize, noOfProcess, processSize, savedOutput));
+        if (!progress) {
+            cerr << "Cannot resume from checkpoint " << checkpointPath << ": unreadable or written by a different run" << endl;
+            return false;
+        }
+        if (!savedOutput.empty())
+            cerr << "Resuming: " << savedOutput.size() << " page sizes restored from " << checkpointPath << endl;
+    }
+
+    static arena sweep;
+    vector<analyze *> analyses;
+    for (int curPageSize = 0; curPageSize <= min(RAMSize, processSize); curPageSize++) {
+        analyses.push_back(analyze::createAnalyze(sweep, noOfProcess, RAMSize, processSize, curPageSize));
+        auto saved = savedOutput.find(curPageSize);
+        if (saved != savedOutput.end())
+            analyses.back()->restoreOutput(saved->second);
+    }
+    analyze::runAll(analyses, progress.get());
+    sweep.release();
+    return true;
+}
+
+void handler::printAnalyzedData() {
+    history::getInstance()->printCurrentStats();
+    if (config::getInstance()->profiled)
+        history::getInstance()->printProfile();
+    const string &curvePath = config::getInstance()->curvePath;
+    if (!curvePath.empty() && !history::getInstance()->saveCurves(curvePath))
+        cerr << "Could not write curves to " << curvePath << endl;
+}
+
+// ------------------------------
+// Definition: analyze class
+// ------------------------------
+analyze::analyze(int noOfProcess, int noOfPages, int noOfRAMPages, int pageSize, int processSize) {
+    this->noOfProcess = noOfProcess;
+    this->noOfPages = noOfPages;
+    this->noOfRAMPages = noOfRAMPages;
+    this->pageSize = pageSize;
+    this->processSize = processSize;
+    this->pendingTasks = 0;
+    this->finished = false;
+    this->representative = NULL;
+    this->curOutput = resultTable(1, algoData::noOfColumns());
+    this->partialOutput = resultTable(threadPool::getInstance()->size(), algoData::noOfColumns());
+    if (config::getInstance()->profiled) {
+        this->curProfile.assign(algoData::noOfColumns(), perfSample());
+        this->partialProfile.assign(threadPool::getInstance()->size() * algoData::noOfColumns(), perfSample());
+    }
+}
+
+analyze *analyze::createAnalyze(arena &memory, int noOfProcess, int RAMSize, int processSize, int pageSize) {
+    int noOfPages = (pageSize == 0) ? -1 : ((processSize + pageSize - 1) / pageSize);
+    int noOfRAMPages = (pageSize == 0) ? -1 : (RAMSize / pageSize);
+    return memory.create<analyze>(noOfProcess, noOfPages, noOfRAMPages, pageSize, processSize);
+}
+
+// The work is split into one root task per process that generates its unit trace, which every
+// configuration then maps to its own page size, and spawns one subtask per configuration; those in
+// turn spawn the simulation, which idle workers steal: a single fused subtask by default, or one
+// per algorithm with --unfused. Configuration subtasks are spawned smallest trace first, so the
+// root's own worker, which pops its newest task, starts the largest and the long tasks do not end
+// up as a serialized tail. Every unit trace is generated from a key derived from the seed and its
+// process index, so generation runs concurrently and still yields the same traces, and therefore
+// the same counts, whatever the number of threads or the order tasks run in.
+// Each worker places the algorithm instances of a simulation in its own scratch arena and releases
+// it when the simulation ends, so the instances cost no allocation once the arenas have grown. The
+// arenas outlive the call and serve every later sweep of a batch.
+// A configuration is finished, and checkpointed, by whichever simulation of it completes last.
+// Neighbouring page sizes often round to the same number of pages and frames, most of all towards
+// the end of a sweep. With --dedupe, such configurations are only simulated once, at the first
+// (smallest) page size of their kind, or not at all if one of them was restored from a checkpoint,
+// and the others report its counts. Their page traces differ, since units fall on pages at other
+// boundaries, so the shared counts are an approximation and this is opt-in. Replayed processes
+// load a separate file per page size and are never merged.
+void analyze::runAll(const vector<analyze *> &analyses, checkpoint *progress) {
+    for (analyze *curAnalyze : analyses)
+        curAnalyze->representative = NULL;
+    map<pair<int, int>, analyze *> representatives;
+    bool deduplicated = config::getInstance()->deduplicated && config::getInstance()->replayDirectory.empty();
+    for (int restored = 1; restored >= 0 && deduplicated; restored--) {
+        for (analyze *curAnalyze : analyses) {
+            if (curAnalyze->finished != (restored == 1) || curAnalyze->noOfPages <= 0)
+                continue;
+            auto inserted = representatives.insert({{curAnalyze->noOfPages, curAnalyze->noOfRAMPages}, curAnalyze});
+            if (!inserted.second && !curAnalyze->finished)
+                curAnalyze->representative = inserted.first->second;
+        }
+    }
+
+    vector<pair<string, algoData *>> columns = algoData::selectedColumns();
+    int groupsPerProcess = (config::getInstance()->fused ? 1 : columns.size()) + (config::getInstance()->curvePath.empty() ? 0 : 1);
+    vector<analyze *> pending;
+    int noOfProcess = 0, processSize = 0;
+    size_t longest = 0;
+    for (analyze *curAnalyze : analyses) {
+        if (curAnalyze->finished || curAnalyze->representative != NULL)
+            continue;
+        curAnalyze->pendingTasks = curAnalyze->noOfProcess * groupsPerProcess;
+        pending.push_back(curAnalyze);
+        noOfProcess = max(noOfProcess, curAnalyze->noOfProcess);
+        processSize = curAnalyze->processSize;
+        if (curAnalyze->noOfPages > 0)
+            longest = max(longest, 100 * (size_t)curAnalyze->noOfPages);
+    }
+    shared_ptr<workload> pattern;
+    if (longest > 0)
+        pattern.reset(workload::createWorkload(config::getInstance()->workloadSpec, processSize));
+
+    threadPool *pool = threadPool::getInstance();
+    static vector<unique_ptr<arena>> scratch;
+    while ((int)scratch.size() < pool->size())
+        scratch.emplace_back(new arena());
+    vector<function<void(int)>> rootTasks;
+    for (int processIndex = 0; processIndex < noOfProcess; processIndex++) {
+        rootTasks.push_back([processIndex, &pending, &columns, pattern, longest, pool, progress](int) {
+            uint64_t key = workload::processKey(config::getInstance()->seed, processIndex);
+            vector<shared_ptr<process>> processes(pending.size());
+            bool generated = false;
+            for (size_t i = 0; i < pending.size(); i++) {
+                processes[i].reset(pending[i]->loadProcess(processIndex));
+                generated |= !processes[i];
+            }
+
+            shared_ptr<const vector<int>> units;
+            if (generated && pattern && !config::getInstance()->streamed) {
+                vector<int> *trace = new vector<int>(longest);
+                pattern->fillAt(trace->data(), key, 0, longest);
+                units.reset(trace);
+            }
+
+            for (size_t i = pending.size(); i-- > 0;) {
+                analyze *curAnalyze = pending[i];
+                if (processIndex >= curAnalyze->noOfProcess)
+                    continue;
+                if (!processes[i])
+                    processes[i].reset(curAnalyze->createProcess(units, pattern, key));
+                shared_ptr<process> curProcess = processes[i];
+                pool->spawn([curAnalyze, curProcess, processIndex, &columns, pool, progress](int) {
+                    curAnalyze->recordProcess(processIndex, curProcess.get());
+                    vector<vector<algoData *>> groups;
+                    for (auto &it : columns) {
+                        if (config::getInstance()->fused && !groups.empty())
+                            groups[0].push_back(it.second);
+                        else
+                            groups.push_back({it.second});
+                    }
+                    for (auto &algos : groups) {
+                        pool->spawn([curAnalyze, curProcess, algos, progress](int worker) {
+                            curAnalyze->runAlgorithms(worker, curProcess.get(), algos, *scratch[worker]);
+                            if (--curAnalyze->pendingTasks == 0)
+                                curAnalyze->finishOutput(progress);
+                        });
+                    }
+                    if (!config::getInstance()->curvePath.empty()) {
+                        pool->spawn([curAnalyze, curProcess, progress](int) {
+                            curAnalyze->runCurves(curProcess.get());
+                            if (--curAnalyze->pendingTasks == 0)
+                                curAnalyze->finishOutput(progress);
+                        });
+                    }
+                });
+            }
+        });
+    }
+    pool->run(move(rootTasks));
+
+    for (analyze *curAnalyze : analyses) {
+        if (!curAnalyze->finished) {
+            if (curAnalyze->representative != NULL) {
+                curAnalyze->curOutput = curAnalyze->representative->curOutput;
+                curAnalyze->LRUCurve = curAnalyze->representative->LRUCurve;
+                curAnalyze->OPTCurve = curAnalyze->representative->OPTCurve;
+            }
+            curAnalyze->finishOutput(progress);
+        }
+        curAnalyze->publishOutput();
+    }
+}
+
+void analyze::restoreOutput(const resultTable &savedOutput) {
+    curOutput = savedOutput;
+    finished = true;
+}
+
+string analyze::traceFileName(int processIndex) const {
+    return "trace_" + to_string(pageSize) + "_" + to_string(processIndex) + ".bin";
+}
+
+process *analyze::loadProcess(int processIndex) {
+    const string &replayDirectory = config::getInstance()->replayDirectory;
+    if (replayDirectory.empty() || pageSize == 0)
+        return NULL;
+    return process::loadProcess(replayDirectory + "/" + traceFileName(processIndex), noOfRAMPages);
+}
+
+process *analyze::createProcess(shared_ptr<const vector<int>> units, shared_ptr<workload> pattern, uint64_t key) {
+    return process::createProcess(noOfPages, noOfRAMPages, pageSize, units, pattern, key);
+}
+
+void analyze::recordProcess(int processIndex, process *curProcess) {
+    const string &recordDirectory = config::getInstance()->recordDirectory;
+    if (recordDirectory.empty() || pageSize == 0)
+        return;
+    string path = recordDirectory + "/" + traceFileName(processIndex);
+    if (!curProcess->saveTrace(path, pageSize))
+        cerr << "Could not write trace file: " << path << endl;
+}
+
+void analyze::runAlgorithms(int worker, process *curProcess, const vector<algoData *> &algos, arena &scratch) {
+    perfSample *profile = partialProfile.empty() ? NULL : &partialProfile[worker * curProfile.size()];
+    curProcess->runAlgorithms(algos, scratch, partialOutput, worker, profile);
+    scratch.release();
+}
+
+// OPT needs the whole trace, so its curve is only computed when the OPT column is selected
+void analyze::runCurves(process *curProcess) {
+    const set<string> &policies = config::getInstance()->policies;
+    missRatioCurve curve = curProcess->createLRUCurve();
+    missRatioCurve optimal = (policies.empty() || policies.count("OPT") > 0) ? curProcess->createOPTCurve() : missRatioCurve();
+    lock_guard<mutex> guard(curveLock);
+    LRUCurve.add(curve);
+    OPTCurve.add(optimal);
+}
+
+void analyze::finishOutput(checkpoint *progress) {
+    for (int worker = 0; worker < partialOutput.getRows(); worker++)
+        curOutput.addRow(0, partialOutput, worker);
+    for (size_t cell = 0; cell < partialProfile.size(); cell++)
+        perfCounters::accumulate(curProfile[cell % curProfile.size()], perfSample(), partialProfile[cell]);
+    finished = true;
+    if (progress != NULL && !progress->saveOutput(pageSize, curOutput))
+        cerr << "Could not write checkpoint for page size " << pageSize << endl;
+}
+
+void analyze::publishOutput() {
+    output *mainOutput = history::getInstance()->getLastElement().second;
+    mainOutput->mergeOutput(this->curOutput);
+    if (config::getInstance()->profiled)
+        mainOutput->mergeProfile(this->curProfile);
+    if (!config::getInstance()->curvePath.empty()) {
+        mainOutput->LRUCurves.push_back(this->LRUCurve);
+        mainOutput->OPTCurves.push_back(this->OPTCurve);
+    }
+}
+
+// ------------------------------
+// Definition: process class
+// ------------------------------
+process::process(int noOfPages, int noOfRAMPages) {
+    this->noOfPages = noOfPages;
+    this->noOfRAMPages = noOfRAMPages;
+    this->pageSize = 1;
+    this->noOfReferences = 0;
+    this->key = 0;
+}
+
+// Without a unit trace the process is streamed: the units of every block are regenerated from the
+// key as the block is needed
+process *process::createProcess(int noOfPages, int noOfRAMPages, int pageSize, shared_ptr<const vector<int>> units,
+                                shared_ptr<workload> pattern, uint64_t key) {
+    process *curProcess = new process(noOfPages, noOfRAMPages);
+    if (noOfPages > 0) {
+        curProcess->pageSize = pageSize;
+        curProcess->noOfReferences = 100 * (size_t)noOfPages;
+        curProcess->units = units;
+        curProcess->pattern = pattern;
+        curProcess->key = key;
+    }
+    return curProcess;
+}
+
+process *process::loadProcess(const string &path, int noOfRAMPages) {
+    shared_ptr<traceFile> file(traceFile::openTrace(path));
+    if (!file)
+        return NULL;
+    process *replayedProcess = new process(file->getView().width(), noOfRAMPages);
+    replayedProcess->replayed = file;
+    return replayedProcess;
+}
+
+// Page sizes that are powers of two map with a shift instead of a division
+void process::mapToPages(const int *units, int *pageID, size_t count, int pageSize) {
+    if ((pageSize & (pageSize - 1)) == 0) {
+        int shift = 0;
+        while ((1 << shift) < pageSize)
+            shift++;
+        for (size_t i = 0; i < count; i++)
+            pageID[i] = ((units[i] - 1) >> shift) + 1;
+    } else {
+        for (size_t i = 0; i < count; i++)
+            pageID[i] = (units[i] - 1) / pageSize + 1;
+    }
+}
+
+void process::fillPages(int *chunk, size_t first, size_t count) const {
+    if (units) {
+        mapToPages(units->data() + first, chunk, count, pageSize);
+    } else {
+        pattern->fillAt(chunk, key, first, count);
+        mapToPages(chunk, chunk, count, pageSize);
+    }
+}
+
+bool process::saveTrace(const string &path, int pageSize) {
+    traceWriter writer(path, pageSize);
+    if (replayed) {
+        writer.append(replayed->getView());
+    } else {
+        vector<int> chunk(FUSED_BLOCK_SIZE);
+        for (size_t first = 0; first < noOfReferences; first += chunk.size()) {
+            size_t count = min(chunk.size(), noOfReferences - first);
+            fillPages(chunk.data(), first, count);
+            writer.append(traceView(chunk.data(), count, noOfPages));
+        }
+    }
+    return writer.close();
+}
+
+// Online algorithms are fed the trace one cache-sized block at a time, each block going through
+// all of them before the next one is loaded, so the trace is streamed from memory once however
+// many algorithms are compared. Algorithms that need the future (OPT) run on the whole trace.
+// Page ids are mapped from the units (or, streamed, generated and mapped) block by block into one
+// reusable buffer; the page trace is materialized (and released again on return) only when an
+// offline algorithm is among the requested ones.
+//
+// With a profile, the counters are read between consecutive algorithm calls and each difference is
+// charged to the algorithm that ran in it, so fused algorithms are told apart block by block and
+// trace generation is charged to none of them.
+void process::runAlgorithms(const vector<algoData *> &algos, arena &scratch, resultTable &counts, int row,
+                            perfSample *profile) {
+    if (noOfPages == -1)
+        return;
+
+    perfCounters *counters = (profile != NULL) ? perfCounters::getInstance() : NULL;
+    perfSample last, now;
+    auto charge = [&](algoData *algo) {
+        now = counters->read();
+        perfCounters::accumulate(profile[algo->algoID], last, now);
+        last = now;
+    };
+
+    traceView trace = replayed ? replayed->getView() : traceView(NULL, 0, noOfPages); // Shared read-only by every algorithm
+    vector<RAM *> instances;
+    vector<onlineRAM *> online;
+    vector<algoData *> onlineAlgos;
+    if (counters)
+        last = counters->read();
+    for (algoData *algo : algos) {
+        RAM *algoInstance = algo->createFunction(scratch, noOfRAMPages, noOfPages, trace);
+        onlineRAM *onlineInstance = dynamic_cast<onlineRAM *>(algoInstance);
+        if (onlineInstance != NULL) {
+            onlineInstance->beginTrace();
+            online.push_back(onlineInstance);
+            onlineAlgos.push_back(algo);
+        }
+        instances.push_back(algoInstance);
+        if (counters)
+            charge(algo);
+    }
+
+    vector<int> materialized;
+    if (!replayed) {
+        if (online.size() == instances.size()) {
+            vector<int> chunk(FUSED_BLOCK_SIZE);
+            for (size_t first = 0; first < noOfReferences; first += chunk.size()) {
+                size_t produced = min(chunk.size(), noOfReferences - first);
+                fillPages(chunk.data(), first, produced);
+                if (counters)
+                    last = counters->read();
+                for (size_t i = 0; i < online.size(); i++) {
+                    online[i]->processBlock(traceView(chunk.data(), produced, noOfPages));
+                    if (counters)
+                        charge(onlineAlgos[i]);
+                }
+            }
+            if (counters)
+                last = counters->read();
+            for (size_t i = 0; i < algos.size(); i++) {
+                counts.add(row, algos[i]->algoID, online[i]->endTrace());
+                if (counters)
+                    charge(algos[i]);
+            }
+            return;
+        }
+        materialized.resize(noOfReferences);
+        fillPages(materialized.data(), 0, noOfReferences);
+        trace = traceView(materialized, noOfPages);
+    }
+
+    if (counters)
+        last = counters->read();
+    for (size_t offset = 0; offset < trace.size(); offset += FUSED_BLOCK_SIZE) {
+        traceView block = trace.slice(offset, min(trace.size() - offset, (size_t)FUSED_BLOCK_SIZE));
+        for (size_t i = 0; i < online.size(); i++) {
+            online[i]->processBlock(block);
+            if (counters)
+                charge(onlineAlgos[i]);
+        }
+    }
+
+    for (size_t i = 0; i < algos.size(); i++) {
+        onlineRAM *onlineInstance = dynamic_cast<onlineRAM *>(instances[i]);
+        if (onlineInstance != NULL)
+            counts.add(row, algos[i]->algoID, onlineInstance->endTrace());
+        else
+            counts.add(row, algos[i]->algoID, instances[i]->processRAM(noOfPages, noOfRAMPages, trace));
+        if (counters)
+            charge(algos[i]);
+    }
+}
+
+// Same Mattson pass as createLRUCurve, fed the blocks the online algorithms see so a streamed trace
+// is never materialized
+missRatioCurve process::createLRUCurve() const {
+    if (noOfPages == -1)
+        return missRatioCurve();
+    stackDistance counter(noOfPages);
+    if (replayed) {
+        counter.processBlock(replayed->getView());
+        return counter.getCurve();
+    }
+    vector<int> chunk(FUSED_BLOCK_SIZE);
+    for (size_t first = 0; first < noOfReferences; first += chunk.size()) {
+        size_t produced = min(chunk.size(), noOfReferences - first);
+        fillPages(chunk.data(), first, produced);
+        counter.processBlock(traceView(chunk.data(), produced, noOfPages));
+    }
+    return counter.getCurve();
+}
+
+// Belady's MIN needs the future, so unlike the LRU pass this one materializes the page trace
+missRatioCurve process::createOPTCurve() const {
+    if (noOfPages == -1)
+        return missRatioCurve();
+    if (replayed)
+        return missRatioCurve::createOPTCurve(replayed->getView());
+    vector<int> materialized(noOfReferences);
+    fillPages(materialized.data(), 0, noOfReferences);
+    return missRatioCurve::createOPTCurve(traceView(materialized, noOfPages));
+}
+
+// ------------------------------
+// Definition: workload class
+// ------------------------------
+workload::workload(int noOfPages) {
+    this->noOfPages = noOfPages;
+}
+
+int workload::width() const { return noOfPages; }
+
+uint64_t workload::mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t workload::random(uint64_t key, size_t index) {
+    return mix(key + (uint64_t)(index + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+// Mixing each field in turn keeps keys of neighbouring seeds and process indices unrelated
+uint64_t workload::processKey(uint64_t seed, int processIndex) {
+    uint64_t fields[2] = {seed, (uint64_t)(uint32_t)processIndex};
+    uint64_t key = 0;
+    for (uint64_t field : fields)
+        key = mix((key ^ field) + 0x9E3779B97F4A7C15ULL);
+    return key;
+}
+
+// A multiply and shift rather than a modulo keeps the loops free of divisions; the bias stays
+// below range / 2^32
+uint32_t workload::scale(uint64_t bits, uint32_t range) {
+    return (uint32_t)(((bits >> 32) * range) >> 32);
+}
+
+// A spec is one or more patterns joined by '+', each written name[:parameter,...][@weight]:
+//   uniform              every page equally likely (the default)
+//   zipf[:alpha]         page p with probability proportional to 1 / p^alpha, alpha defaults to 0.99
+//   scan                 all pages in order
+//   loop[:fraction]      the same window of fraction * pages in order, fraction defaults to 0.5
+//   phases[:fraction,n]  uniform inside a working set of fraction * pages (default 0.1) that moves
+//                        every n * pages references (default 10)
+// Weights default to 1 and are only meaningful in a mixture.
+workload *workload::createWorkload(const string &spec, int noOfPages) {
+    vector<unique_ptr<workload>> components;
+    vector<double> weights;
+    stringstream specStream(spec);
+    string part;
+    while (getline(specStream, part, '+')) {
+        double weight = 1;
+        size_t at = part.find('@');
+        if (at != string::npos) {
+            char *end;
+            weight = strtod(part.c_str() + at + 1, &end);
+            if (*end != '\0' || at + 1 == part.size() || !(weight > 0))
+                return NULL;
+            part.resize(at);
+        }
+
+        size_t colon = part.find(':');
+        string name = part.substr(0, colon);
+        vector<double> parameters;
+        if (colon != string::npos) {
+            stringstream parameterStream(part.substr(colon + 1));
+            string parameter;
+            while (getline(parameterStream, parameter, ',')) {
+                char *end;
+                parameters.push_back(strtod(parameter.c_str(), &end));
+                if (*end != '\0' || parameter.empty())
+                    return NULL;
+            }
+            if (parameters.empty())
+                return NULL;
+        }
+
+        workload *component = NULL;
+        if (name == "uniform" && parameters.empty()) {
+            component = new uniformWorkload(noOfPages);
+        } else if (name == "scan" && parameters.empty()) {
+            component = new scanWorkload(noOfPages);
+        } else if (name == "zipf" && parameters.size() <= 1) {
+            double alpha = parameters.empty() ? 0.99 : parameters[0];
+            if (alpha >= 0)
+                component = new zipfWorkload(noOfPages, alpha);
+        } else if (name == "loop" && parameters.size() <= 1) {
+            double fraction = parameters.empty() ? 0.5 : parameters[0];
+            if (fraction > 0 && fraction <= 1)
+                component = new loopWorkload(noOfPages, fraction);
+        } else if (name == "phases" && parameters.size() <= 2) {
+            double fraction = parameters.size() > 0 ? parameters[0] : 0.1;
+            double phaseLength = parameters.size() > 1 ? parameters[1] : 10;
+            if (fraction > 0 && fraction <= 1 && phaseLength > 0)
+                component = new phaseWorkload(noOfPages, fraction, phaseLength);
+        }
+        if (component == NULL)
+            return NULL;
+        components.emplace_back(component);
+        weights.push_back(weight);
+    }
+
+    if (components.empty())
+        return NULL;
+    if (components.size() == 1)
+        return components[0].release();
+    return new mixtureWorkload(noOfPages, move(components), weights);
+}
+
+// ------------------------------
+// Definition: uniformWorkload class
+// ------------------------------
+void uniformWorkload::fillAt(int *chunk, uint64_t key, size_t first, size_t count) const {
+    for (size_t i = 0; i < count; i++)
+        chunk[i] = (int)scale(random(key, first + i), noOfPages) + 1;
+}
+
+// ------------------------------
+// Definition: zipfWorkload class
+// ------------------------------
+zipfWorkload::zipfWorkload(int noOfPages, double alpha) : workload(noOfPages) {
+    vector<double> probability(noOfPages);
+    double sum = 0;
+    for (int page = 0; page < noOfPages; page++)
+        sum += probability[page] = pow(page + 1.0, -alpha);
+
+    // Vose's method: columns below the average are topped up by one above it
+    vector<int> small, large;
+    for (int page = 0; page < noOfPages; page++) {
+        probability[page] *= noOfPages / sum;
+        (probability[page] < 1 ? small : large).push_back(page);
+    }
+    threshold.assign(noOfPages, UINT32_MAX);
+    alias.resize(noOfPages);
+    for (int page = 0; page < noOfPages; page++)
+        alias[page] = page;
+    while (!small.empty() && !large.empty()) {
+        int less = small.back(), more = large.back();
+        small.pop_back();
+        threshold[less] = (uint32_t)(probability[less] * 4294967296.0);
+        alias[less] = more;
+        probability[more] -= 1 - probability[less];
+        if (probability[more] < 1) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+}
+
+void zipfWorkload::fillAt(int *chunk, uint64_t key, size_t first, size_t count) const {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits = random(key, first + i);
+        uint32_t column = scale(bits, noOfPages);
+        chunk[i] = ((uint32_t)bits < threshold[column] ? (int)column : alias[column]) + 1;
+    }
+}
+
+// ------------------------------
+// Definition: scanWorkload class
+// ------------------------------
+void scanWorkload::fillAt(int *chunk, uint64_t key, size_t first, size_t count) const {
+    int page = (int)((scale(mix(key), noOfPages) + first % noOfPages) % noOfPages);
+    for (size_t i = 0; i < count; i++) {
+        chunk[i] = page + 1;
+        if (++page == noOfPages)
+            page = 0;
+    }
+}
+
+// ------------------------------
+// Definition: loopWorkload class
+// ------------------------------
+void loopWorkload::fillAt(int *chunk, uint64_t key, size_t first, size_t count) const {
+    int window = max(1, min(noOfPages, (int)(fraction * noOfPages)));
+    int base = (int)scale(mix(key), noOfPages - window + 1);
+    int offset = (int)(first % window);
+    for (size_t i = 0; i < count; i++) {
+        chunk[i] = base + offset + 1;
+        if (++offset == window)
+            offset = 0;
+    }
+}
+
+// ------------------------------
+// Definition: phaseWorkload class
+// ------------------------------
+void phaseWorkload::fillAt(int *chunk, uint64_t key, size_t first, size_t count) const {
+    int window = max(1, min(noOfPages, (int)(fraction * noOfPages)));
+    size_t referencesPerPhase = max((size_t)1, (size_t)(phaseLength * noOfPages));
+    size_t phase = first / referencesPerPhase;
+    size_t done = 0;
+    while (done < count) {
+        size_t index = first + done;
+        size_t segment = min(count - done, (phase + 1) * referencesPerPhase - index);
+        int base = (int)scale(random(key ^ 0xD1B54A32D192ED03ULL, phase), noOfPages);
+        for (size_t i = 0; i < segment; i++) {
+            int page = base + (int)scale(random(key, index + i), window);
+            chunk[done + i] = (page >= noOfPages ? page - noOfPages : page) + 1;
+        }
+        done += segment;
+        phase++;
+    }
+}
+
+// ------------------------------
+// Definition: mixtureWorkload class
+// ------------------------------
+mixtureWorkload::mixtureWorkload(int noOfPages, vector<unique_ptr<workload>> &&components, const vector<double> &weights)
+    : workload(noOfPages) {
+    this->components = move(components);
+    double total = accumulate(weights.begin(), weights.end(), 0.0), sum = 0;
+    for (double weight : weights) {
+        sum += weight;
+        upperBound.push_back((uint32_t)min(sum / total * 4294967296.0, 4294967295.0));
+    }
+}
+
+// Every component fills the chunk with its own key, then each reference keeps the value of the
+// component its selection bits fall into. Work is done in slices that stay in cache.
+void mixtureWorkload::fillAt(int *chunk, uint64_t key, size_t first, size_t count) const {
+    const size_t sliceSize = 4096;
+    vector<int> values(components.size() * min(count, sliceSize));
+    uint64_t selectionKey = mix(key ^ 0x5851F42D4C957F2DULL);
+    for (size_t done = 0; done < count; done += sliceSize) {
+        size_t slice = min(count - done, sliceSize);
+        for (size_t c = 0; c < components.size(); c++)
+            components[c]->fillAt(&values[c * slice], mix(key + (c + 1) * 0xD1B54A32D192ED03ULL), first + done, slice);
+        for (size_t i = 0; i < slice; i++) {
+            uint32_t selection = (uint32_t)(random(selectionKey, first + done + i) >> 32);
+            size_t c = 0;
+            while (c + 1 < components.size() && selection >= upperBound[c])
+                c++;
+            chunk[done + i] = values[c * slice + i];
+        }
+    }
+}
+
+// ------------------------------
+// Definition: traceFile class
+// ------------------------------
+traceFile::traceFile() {
+    this->mapped = NULL;
+    this->mappedLength = 0;
+    this->ids = NULL;
+    this->count = 0;
+    this->noOfPages = 0;
+}
+
+traceFile *traceFile::openTrace(const string &path) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open())
+        return NULL;
+    header fileHeader;
+    if (!file.read((char *)&fileHeader, sizeof(header)) || memcmp(fileHeader.magic, TRACE_MAGIC, 4) != 0 ||
+        fileHeader.version != TRACE_VERSION ||
+        (fileHeader.idWidth != 1 && fileHeader.idWidth != 2 && fileHeader.idWidth != 4) ||
+        fileHeader.noOfPages == 0 || fileHeader.noOfPages > (uint32_t)INT_MAX || fileHeader.count == 0 ||
+        fileHeader.count > (SIZE_MAX - sizeof(header)) / fileHeader.idWidth) {
+        cerr << "Malformed trace file: " << path << endl;
+        return NULL;
+    }
+
+    // The count is checked against the length of the file before anything is sized from it
+    size_t dataLength = fileHeader.count * fileHeader.idWidth;
+    file.seekg(0, ios::end);
+    streamoff fileLength = file.tellg();
+    if (fileLength < 0 || (uint64_t)fileLength < sizeof(header) + dataLength) {
+        cerr << "Truncated trace file: " << path << endl;
+        return NULL;
+    }
+    file.seekg(sizeof(header));
+
+    traceFile *trace = new traceFile();
+    trace->count = fileHeader.count;
+    trace->noOfPages = fileHeader.noOfPages;
+
+#ifdef HAS_MMAP
+    if (fileHeader.idWidth == sizeof(int)) {
+        int descriptor = open(path.c_str(), O_RDONLY);
+        struct stat status;
+        if (descriptor >= 0 && fstat(descriptor, &status) == 0 && (size_t)status.st_size >= sizeof(header) + dataLength) {
+            trace->mappedLength = sizeof(header) + dataLength;
+            void *mapped = mmap(NULL, trace->mappedLength, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (mapped != MAP_FAILED) {
+                madvise(mapped, trace->mappedLength, MADV_SEQUENTIAL);
+                trace->mapped = mapped;
+                trace->ids = (const int *)((const char *)mapped + sizeof(header));
+            }
+        }
+        if (descriptor >= 0)
+            close(descriptor);
+        if (trace->mapped != NULL) {
+            for (size_t i = 0; i < trace->count; i++) {
+                if (trace->ids[i] < 1 || trace->ids[i] > trace->noOfPages) {
+                    cerr << "Trace file " << path << " has page id " << trace->ids[i] << " outside [1, "
+                         << trace->noOfPages << "]" << endl;
+                    delete trace;
+                    return NULL;
+                }
+            }
+            return trace;
+        }
+    }
+#endif
+
+    vector<char> packed(dataLength);
+    if (!file.read(packed.data(), dataLength)) {
+        cerr << "Truncated trace file: " << path << endl;
+        delete trace;
+        return NULL;
+    }
+    trace->widened.resize(fileHeader.count);
+    for (size_t i = 0; i < fileHeader.count; i++) {
+        int id;
+        if (fileHeader.idWidth == 1)
+            id = (uint8_t)packed[i];
+        else if (fileHeader.idWidth == 2)
+            id = ((const uint16_t *)packed.data())[i];
+        else
+            id = ((const int32_t *)packed.data())[i];
+        if (id < 1 || id > trace->noOfPages) {
+            cerr << "Trace file " << path << " has page id " << id << " outside [1, " << trace->noOfPages << "]" << endl;
+            delete trace;
+            return NULL;
+        }
+        trace->widened[i] = id;
+    }
+    trace->ids = trace->widened.data();
+    return trace;
+}
+
+traceFile::~traceFile() {
+#ifdef HAS_MMAP
+    if (mapped != NULL)
+        munmap(mapped, mappedLength);
+#endif
+}
+
+traceView traceFile::getView() const {
+    return traceView(ids, count, noOfPages);
+}
+
+// ------------------------------
+// Definition: traceWriter class
+// ------------------------------
+traceWriter::traceWriter(const string &path, int pageSize) : path(path), file(path + ".tmp", ios::binary | ios::trunc) {
+    memset(&fileHeader, 0, sizeof(fileHeader));
+    memcpy(fileHeader.magic, TRACE_MAGIC, 4);
+    fileHeader.version = TRACE_VERSION;
+    fileHeader.idWidth = sizeof(int);
+    fileHeader.pageSize = pageSize;
+    this->largestID = 0;
+    file.write((const char *)&fileHeader, sizeof(fileHeader));
+}
+
+bool traceWriter::append(traceView block) {
+    for (int id : block)
+        largestID = max(largestID, id);
+    fileHeader.count += block.size();
+    file.write((const char *)block.begin(), block.size() * sizeof(int));
+    return (bool)file;
+}
+
+bool traceWriter::close() {
+    fileHeader.noOfPages = largestID;
+    file.seekp(0);
+    file.write((const char *)&fileHeader, sizeof(fileHeader));
+    file.close();
+    if (file.fail() || rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+        remove((path + ".tmp").c_str());
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------
+// Definition: checkpoint class
+// ------------------------------
+checkpoint::checkpoint() {}
+
+checkpoint *checkpoint::openCheckpoint(const string &path, int RAMSize, int noOfProcess, int processSize,
+                                       map<int, resultTable> &savedOutput) {
+    header runHeader;
+    memset(&runHeader, 0, sizeof(runHeader));
+    memcpy(runHeader.magic, CHECKPOINT_MAGIC, 4);
+    runHeader.version = CHECKPOINT_VERSION;
+    runHeader.RAMSize = RAMSize;
+    runHeader.noOfProcess = noOfProcess;
+    runHeader.processSize = processSize;
+    unique_ptr<checkpoint> progress(new checkpoint());
+    progress->columns.push_back(0);
+    for (auto &column : algoData::selectedColumns())
+        progress->columns.push_back(column.second->algoID);
+    runHeader.noOfColumns = progress->columns.size();
+    runHeader.seed = config::getInstance()->seed;
+    runHeader.fingerprint = runFingerprint();
+
+    progress->file.open(path, ios::binary | ios::in | ios::out);
+    if (!progress->file.is_open()) {
+        progress->file.clear();
+        progress->file.open(path, ios::binary | ios::out | ios::trunc);
+        progress->file.write((const char *)&runHeader, sizeof(runHeader));
+        progress->file.flush();
+        return progress->file.good() ? progress.release() : NULL;
+    }
+
+    header fileHeader;
+    if (!progress->file.read((char *)&fileHeader, sizeof(fileHeader)) ||
+        memcmp(&fileHeader, &runHeader, sizeof(header)) != 0)
+        return NULL;
+
+    size_t recordSize = 2 * sizeof(int32_t) + 2 * runHeader.noOfColumns * sizeof(int64_t);
+    vector<char> record(recordSize);
+    streamoff validEnd = sizeof(header);
+    while (progress->file.read(record.data(), recordSize)) {
+        int32_t pageSize;
+        memcpy(&pageSize, record.data(), sizeof(pageSize));
+        resultTable curOutput(1, algoData::noOfColumns());
+        const char *values = record.data() + 2 * sizeof(int32_t);
+        for (uint32_t column = 0; column < runHeader.noOfColumns; column++) {
+            stats counts;
+            memcpy(&counts.missCount, values + 2 * column * sizeof(int64_t), sizeof(int64_t));
+            memcpy(&counts.total, values + (2 * column + 1) * sizeof(int64_t), sizeof(int64_t));
+            curOutput.add(0, progress->columns[column], counts);
+        }
+        savedOutput[pageSize] = curOutput;
+        validEnd += recordSize;
+    }
+    progress->file.clear();
+    progress->file.seekp(validEnd);
+    return progress->file.good() ? progress.release() : NULL;
+}
+
+// FNV-1a over a description of the settings that change the counts; the thread count, fusion and
+// streaming never do. Only the columns --policies selects are described, so a run of every column
+// keeps the fingerprint it had before policies could be chosen.
+uint64_t checkpoint::runFingerprint() {
+    config *settings = config::getInstance();
+    string description = settings->workloadSpec + "|" + to_string(settings->sampleBudget) + "|" + to_string(settings->gclockBits) +
+                         "|" + settings->replayDirectory +
+                         (settings->deduplicated && settings->replayDirectory.empty() ? "|dedupe" : "");
+    map<string, string> activeEngines;
+    for (auto &column : algoData::selectedColumns())
+        for (auto &engine : engines)
+            if (engine.second == column.second)
+                activeEngines[column.first] = engine.first;
+    for (auto &engine : activeEngines)
+        description += "|" + engine.first + "=" + engine.second;
+
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : description)
+        hash = (hash ^ c) * 0x100000001B3ULL;
+    return hash;
+}
+
+bool checkpoint::saveOutput(int pageSize, const resultTable &curOutput) {
+    vector<char> record(2 * sizeof(int32_t) + 2 * columns.size() * sizeof(int64_t), 0);
+    int32_t recordPageSize = pageSize;
+    memcpy(record.data(), &recordPageSize, sizeof(recordPageSize));
+    char *values = record.data() + 2 * sizeof(int32_t);
+    for (size_t column = 0; column < columns.size() && columns[column] < curOutput.getColumns(); column++) {
+        stats counts = curOutput.get(0, columns[column]);
+        memcpy(values + 2 * column * sizeof(int64_t), &counts.missCount, sizeof(int64_t));
+        memcpy(values + (2 * column + 1) * sizeof(int64_t), &counts.total, sizeof(int64_t));
+    }
+
+    lock_guard<mutex> guard(lock);
+    file.write(record.data(), record.size());
+    file.flush();
+    return file.good();
+}
+
+// ------------------------------
+// Definition: perfCounters class
+// ------------------------------
+perfCounters::perfCounters() {
+    this->leader = -1;
+    this->noOfOpened = 0;
+    for (int event = 0; event < NO_OF_EVENTS; event++) {
+        this->descriptor[event] = -1;
+        this->slot[event] = -1;
+    }
+#ifdef HAS_PERF_EVENTS
+    const uint64_t configs[NO_OF_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int event = 0; event < NO_OF_EVENTS; event++) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[event];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.disabled = (leader == -1);
+        int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+        if (fd < 0)
+            continue;
+        if (leader == -1)
+            leader = fd;
+        descriptor[event] = fd;
+        slot[event] = noOfOpened++;
+    }
+    if (leader != -1) {
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+perfCounters::~perfCounters() {
+#ifdef HAS_PERF_EVENTS
+    for (int event = 0; event < NO_OF_EVENTS; event++)
+        if (descriptor[event] != -1)
+            close(descriptor[event]);
+#endif
+}
+
+perfCounters *perfCounters::getInstance() {
+    static thread_local unique_ptr<perfCounters> currentInstance;
+    if (!currentInstance)
+        currentInstance.reset(new perfCounters());
+    return currentInstance.get();
+}
+
+perfSample perfCounters::read() const {
+    perfSample sample = perfSample();
+#ifdef HAS_PERF_EVENTS
+    if (leader != -1) {
+        uint64_t values[1 + NO_OF_EVENTS];
+        if (::read(leader, values, sizeof(uint64_t) * (1 + noOfOpened)) > 0) {
+            int64_t *fields[NO_OF_EVENTS] = {&sample.cycles, &sample.instructions, &sample.cacheMisses, &sample.branchMisses};
+            for (int event = 0; event < NO_OF_EVENTS; event++)
+                if (slot[event] != -1)
+                    *fields[event] = values[1 + slot[event]];
+        }
+    }
+#endif
+    sample.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    return sample;
+}
+
+void perfCounters::accumulate(perfSample &target, const perfSample &start, const perfSample &finish) {
+    target.nanoseconds += finish.nanoseconds - start.nanoseconds;
+    target.cycles += finish.cycles - start.cycles;
+    target.instructions += finish.instructions - start.instructions;
+    target.cacheMisses += finish.cacheMisses - start.cacheMisses;
+    target.branchMisses += finish.branchMisses - start.branchMisses;
+}
+
+// ------------------------------
+// Definition: traceView class
+// ------------------------------
+traceView::traceView() : data(NULL), length(0), pageIDWidth(0) {}
+
+traceView::traceView(const int *data, size_t length, int pageIDWidth)
+    : data(data), length(length), pageIDWidth(pageIDWidth) {}
+
+traceView::traceView(const vector<int> &pageID, int pageIDWidth)
+    : data(pageID.data()), length(pageID.size()), pageIDWidth(pageIDWidth) {}
+
+size_t traceView::size() const { return length; }
+int traceView::width() const { return pageIDWidth; }
+const int &traceView::operator[](size_t i) const { return data[i]; }
+const int *traceView::begin() const { return data; }
+const int *traceView::end() const { return data + length; }
+
+traceView traceView::slice(size_t offset, size_t count) const {
+    return traceView(data + offset, count, pageIDWidth);
+}
+
+// ------------------------------
+// Definition: arena class
+// ------------------------------
+arena::arena(size_t blockSize) {
+    this->blocks.push_back({unique_ptr<char[]>(new char[blockSize]), blockSize});
+    this->currentBlock = 0;
+    this->used = 0;
+}
+
+arena::~arena() {
+    release();
+}
+
+void *arena::allocate(size_t size, size_t alignment) {
+    while (true) {
+        block &current = blocks[currentBlock];
+        uintptr_t base = (uintptr_t)current.data.get();
+        size_t offset = ((base + used + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+        if (offset + size <= current.size) {
+            used = offset + size;
+            return current.data.get() + offset;
+        }
+        if (currentBlock + 1 == blocks.size()) {
+            size_t blockSize = max(current.size * 2, size + alignment);
+            blocks.push_back({unique_ptr<char[]>(new char[blockSize]), blockSize});
+        }
+        currentBlock++;
+        used = 0;
+    }
+}
+
+void arena::release() {
+    for (size_t i = destructors.size(); i-- > 0;)
+        destructors[i].second(destructors[i].first);
+    destructors.clear();
+
+    if (blocks.size() > 1) {
+        size_t totalSize = 0;
+        for (auto &curBlock : blocks)
+            totalSize += curBlock.size;
+        blocks.clear();
+        blocks.push_back({unique_ptr<char[]>(new char[totalSize]), totalSize});
+    }
+    currentBlock = 0;
+    used = 0;
+}
+
+// ------------------------------
+// Definition: RAM class
+// ------------------------------
+RAM::RAM(int noOfRAMPages, int noOfPages, traceView pageID) {
     this->noOfPages = noOfPages;
     this->noOfRAMPages = noOfRAMPages;
     this->pageID = pageID;
 }
 
+// ------------------------------
+// Definition: onlineRAM class
+// ------------------------------
+onlineRAM::onlineRAM(int noOfRAMPages, int noOfPages, traceView pageID) : RAM(noOfRAMPages, noOfPages, pageID) {
+    this->missCount = 0;
+    this->total = 0;
+}
+
+stats onlineRAM::processRAM(int noOfPages, int noOfRAMPages, traceView pageID) {
+    this->noOfPages = noOfPages;
+    this->noOfRAMPages = noOfRAMPages;
+    this->pageID = pageID;
+    beginTrace();
+    processBlock(pageID);
+    return endTrace();
+}
+
+void onlineRAM::beginTrace() {
+    missCount = 0;
+    total = 0;
+}
+
+stats onlineRAM::endTrace() {
+    return {missCount, total};
+}
+
 // ------------------------------
 // Definition: algoData class
 // ------------------------------
-algoData::algoData(function<RAM *(int, int, vector<int>)> createFunction, int algoID) {
+algoData::algoData(function<RAM *(arena &, int, int, traceView)> createFunction, int algoID) {
     this->algoID = algoID;
     this->createFunction = createFunction;
 }
 
+bool algoData::selectEngine(const string &engineName) {
+    auto engine = engines.find(engineName);
+    size_t separator = engineName.find(':');
+    if (engine == engines.end() || separator == string::npos)
+        return false;
+    mapping[engineName.substr(0, separator)] = engine->second;
+    return true;
+}
+
+vector<pair<string, algoData *>> algoData::selectedColumns() {
+    const set<string> &policies = config::getInstance()->policies;
+    vector<pair<string, algoData *>> columns;
+    for (auto &column : mapping)
+        if (policies.empty() || policies.count(column.first) > 0)
+            columns.push_back(column);
+    sort(columns.begin(), columns.end(), [](const pair<string, algoData *> &a, const pair<string, algoData *> &b)
+         { return a.second->algoID < b.second->algoID; });
+    return columns;
+}
+
+// Result tables are indexed by algoID whichever columns run, so unselected columns stay zero
+int algoData::noOfColumns() {
+    int noOfColumns = 1;
+    for (auto &engine : engines)
+        noOfColumns = max(noOfColumns, engine.second->algoID + 1);
+    return noOfColumns;
+}
+
+// ------------------------------
+// Definition: missRatioCurve class
+// ------------------------------
+missRatioCurve::missRatioCurve() : hitsUpTo(1, 0), total(0) {}
+
+missRatioCurve::missRatioCurve(vector<long long> &&hitsUpTo, long long total) {
+    this->hitsUpTo = move(hitsUpTo);
+    this->total = total;
+}
+
+missRatioCurve missRatioCurve::createLRUCurve(traceView pageID) {
+    stackDistance counter(pageID.width());
+    counter.processBlock(pageID);
+    return counter.getCurve();
+}
+
+missRatioCurve missRatioCurve::createSampledLRUCurve(traceView pageID, int sampleBudget) {
+    sampledStackDistance counter(pageID.width(), sampleBudget);
+    counter.processBlock(pageID);
+    return counter.getCurve();
+}
+
+// MIN is a stack algorithm when pages are ranked by next use (Mattson et al.): the stack holds the
+// contents of every cache size at once, and a reference found at depth d hits for all sizes >= d.
+// On a reference to x at depth d, x moves to the top and the displaced pages ripple down to d,
+// each slot keeping whichever of (carried page, resident page) is needed sooner. That ripple is a
+// linear pass over two flat arrays, so a reference costs O(d): close to one simulation on traces
+// with locality, but O(m) on uniformly random ones. maxFrames bounds the stack, and with it the
+// cost, for callers that only need the curve up to a given cache size; 0 means every size.
+missRatioCurve missRatioCurve::createOPTCurve(traceView pageID, int maxFrames) {
+    vector<int> remapped;
+    traceView ids = OPT::denseView(pageID, remapped);
+    vector<size_t> nxtOcc = OPT::nextOccurrence(ids);
+    size_t total = ids.size();
+    int width = max(ids.width(), 1);
+    int limit = (maxFrames <= 0) ? width : min(maxFrames, width);
+
+    vector<int> stackPage(limit + 1, 0);                           // Page at each depth (1 = top)
+    vector<size_t> stackNext(limit + 1, 0);                        // Next use of the page at each depth
+    vector<int> depthOf(width + 1, 0);                             // Depth of each page, 0 if not on the stack
+    vector<long long> distanceCount(width + 1, 0);
+    int depth = 0;
+
+    for (size_t i = 0; i < total; i++) {
+        int page = ids[i];
+        int found = depthOf[page];
+        if (found)
+            distanceCount[found]++;
+
+        int end = found ? found : depth;
+        int carriedPage = page;
+        size_t carriedNext = nxtOcc[i];
+        for (int slot = 1; slot < end || (slot == end && !found); slot++) {
+            if (stackNext[slot] > carriedNext || slot == 1) {
+                swap(carriedPage, stackPage[slot]);
+                swap(carriedNext, stackNext[slot]);
+                depthOf[stackPage[slot]] = slot;
+            }
+        }
+        if (found) {
+            stackPage[found] = carriedPage;
+            stackNext[found] = carriedNext;
+            depthOf[carriedPage] = found;
+        } else if (depth < limit) {
+            depth++;
+            stackPage[depth] = carriedPage;
+            stackNext[depth] = carriedNext;
+            depthOf[carriedPage] = depth;
+        } else {
+            depthOf[carriedPage] = 0;
+        }
+    }
+
+    vector<long long> hitsUpTo(limit + 1, 0);
+    for (int k = 1; k <= limit; k++)
+        hitsUpTo[k] = hitsUpTo[k - 1] + distanceCount[k];
+    return missRatioCurve(move(hitsUpTo), total);
+}
+
+long long missRatioCurve::getMissCount(int noOfRAMPages) const {
+    int frames = min(max(noOfRAMPages, 0), (int)hitsUpTo.size() - 1);
+    return total - hitsUpTo[frames];
+}
+
+long long missRatioCurve::getTotal() const { return total; }
+
+double missRatioCurve::getMissRatio(int noOfRAMPages) const {
+    return total == 0 ? 0.0 : 1.0 * getMissCount(noOfRAMPages) / total;
+}
+
+int missRatioCurve::getMaxFrames() const {
+    return hitsUpTo.size() - 1;
+}
+
+// Curves of traces over different numbers of pages are flat past their width, so the shorter one is
+// extended with its last value
+void missRatioCurve::add(const missRatioCurve &curve) {
+    if (curve.hitsUpTo.size() > hitsUpTo.size())
+        hitsUpTo.resize(curve.hitsUpTo.size(), hitsUpTo.back());
+    for (size_t k = 0; k < hitsUpTo.size(); k++)
+        hitsUpTo[k] += curve.hitsUpTo[min(k, curve.hitsUpTo.size() - 1)];
+    total += curve.total;
+}
+
+// ------------------------------
+// Definition: stackDistance class
+// ------------------------------
+// Each reference's stack distance is the number of distinct pages touched since the previous
+// reference to the same page. A Fenwick tree marks the latest access time of every page, so the
+// distance is a suffix count. Times are compacted whenever the 2m slots run out, which keeps the
+// tree at O(m) and each reference at amortized O(log m).
+stackDistance::stackDistance(int pageIDWidth, int maxActive) {
+    int width = max(pageIDWidth, 1);
+    this->capacity = 2 * ((maxActive > 0) ? min(maxActive, width) : width);
+    this->fenwick.assign(capacity + 1, 0);
+    this->pageAt.assign(capacity, 0);
+    this->lastTime.assign(width + 1, -1);
+    this->distanceCount.assign(width + 1, 0);
+    this->nextTime = 0;
+    this->active = 0;
+    this->total = 0;
+}
+
+void stackDistance::add(int pos, int delta) {
+    for (pos++; pos <= capacity; pos += pos & -pos)
+        fenwick[pos] += delta;
+}
+
+int stackDistance::prefix(int pos) const {
+    int sum = 0;
+    for (pos++; pos > 0; pos -= pos & -pos)
+        sum += fenwick[pos];
+    return sum;
+}
+
+void stackDistance::compact() {
+    int compacted = 0;
+    for (int pos = 0; pos < capacity; pos++) {
+        int page = pageAt[pos];
+        pageAt[pos] = 0;
+        if (page != 0 && lastTime[page] == pos) {
+            lastTime[page] = compacted;
+            pageAt[compacted++] = page;
+        }
+    }
+    fill(fenwick.begin(), fenwick.end(), 0);
+    for (int pos = 0; pos < compacted; pos++)
+        add(pos, 1);
+    nextTime = compacted;
+}
+
+int stackDistance::reference(int id) {
+    if (nextTime == capacity)
+        compact();
+
+    int distance = 0;
+    int previous = lastTime[id];
+    if (previous >= 0) {
+        distance = active - prefix(previous) + 1;
+        add(previous, -1);
+        active--;
+    }
+    add(nextTime, 1);
+    pageAt[nextTime] = id;
+    lastTime[id] = nextTime++;
+    active++;
+    return distance;
+}
+
+void stackDistance::remove(int id) {
+    if (lastTime[id] < 0)
+        return;
+    add(lastTime[id], -1);
+    lastTime[id] = -1;
+    active--;
+}
+
+void stackDistance::processBlock(traceView block) {
+    for (int id : block) {
+        int distance = reference(id);
+        if (distance > 0)
+            distanceCount[distance]++;
+    }
+    total += block.size();
+}
+
+missRatioCurve stackDistance::getCurve() const {
+    int width = distanceCount.size() - 1;
+    vector<long long> hitsUpTo(width + 1, 0);
+    for (int k = 1; k <= width; k++)
+        hitsUpTo[k] = hitsUpTo[k - 1] + distanceCount[k];
+    return missRatioCurve(move(hitsUpTo), total);
+}
+
+// ------------------------------
+// Definition: sampledStackDistance class
+// ------------------------------
+sampledStackDistance::sampledStackDistance(int pageIDWidth, int sampleBudget)
+    : counter(pageIDWidth, sampleBudget + 1) {
+    this->sampleBudget = max(sampleBudget, 1);
+    this->sampledPages = 0;
+    this->threshold = 1ULL << 32;
+    this->weightAt.assign(max(pageIDWidth, 1) + 2, 0);
+    this->sampledWeight = 0;
+    this->total = 0;
+}
+
+// A reuse at distance d in a sample taken at rate R stands for one at distance d / R in the trace,
+// and for 1 / R reuses, since only about R of the references around it were sampled.
+void sampledStackDistance::processBlock(traceView block) {
+    int width = weightAt.size() - 2;
+    for (int id : block) {
+        uint32_t hash = (uint32_t)workload::mix((uint64_t)id);
+        if (hash >= threshold)
+            continue;
+        int distance = counter.reference(id);
+        double rate = threshold / 4294967296.0;
+        sampledWeight += 1 / rate;
+        if (distance > 0) {
+            int scaled = (int)min(ceil(distance / rate), (double)width + 1);
+            weightAt[scaled] += 1 / rate;
+            continue;
+        }
+
+        largestHash.push({hash, id});
+        if (++sampledPages <= sampleBudget)
+            continue;
+        threshold = largestHash.top().first;
+        while (!largestHash.empty() && largestHash.top().first >= threshold) {
+            counter.remove(largestHash.top().second);
+            largestHash.pop();
+            sampledPages--;
+        }
+    }
+    total += block.size();
+}
+
+// Misses with k frames are the sampled references that were not reuses within distance k. Dividing
+// them by the exact reference count rather than by the sampled weight credits the difference
+// between the two to the smallest distance, which is the SHARDS-adj correction for samples that
+// happen to hold more or fewer references than the rate predicts.
+missRatioCurve sampledStackDistance::getCurve() const {
+    int width = weightAt.size() - 2;
+    vector<long long> hitsUpTo(width + 1, 0);
+    double hits = 0;
+    for (int k = 1; k <= width; k++) {
+        hits += weightAt[k];
+        double misses = min((double)total, max(0.0, sampledWeight - hits));
+        hitsUpTo[k] = total - llround(misses);
+    }
+    return missRatioCurve(move(hitsUpTo), total);
+}
+
+// ------------------------------
+// Definition: pageList class
+// ------------------------------
+pageList::pageList(int pageIDWidth) : prev(pageIDWidth + 1, -1), next(pageIDWidth + 1, 0), count(0) {
+    prev[0] = next[0] = 0;
+}
+
+bool pageList::contains(int id) const { return prev[id] != -1; }
+int pageList::size() const { return count; }
+int pageList::front() const { return next[0]; }
+int pageList::back() const { return prev[0]; }
+
+void pageList::pushFront(int id) {
+    int oldFront = next[0];
+    prev[id] = 0;
+    next[id] = oldFront;
+    prev[oldFront] = id;
+    next[0] = id;
+    count++;
+}
+
+void pageList::remove(int id) {
+    next[prev[id]] = next[id];
+    prev[next[id]] = prev[id];
+    prev[id] = -1;
+    count--;
+}
+
 // ------------------------------
 // Algorithm Implementations
 // ------------------------------
-vector<int> FIFO::processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) {
-    int missCount = 0, total = pageID.size();
-    unordered_set<int> cache;
-    queue<int> order;
+void FIFO::beginTrace() {
+    onlineRAM::beginTrace();
+    cache.clear();
+    order = queue<int>();
+}
 
-    for (int id : pageID) {
+void FIFO::processBlock(traceView block) {
+    for (int id : block) {
         if (!cache.count(id)) {
             missCount++;
             if (cache.size() == noOfRAMPages) {
@@ -444,16 +2948,237 @@ vector<int> FIFO::processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID
             order.push(id);
         }
     }
-    return {missCount, total};
+    total += block.size();
+}
+
+void FIFORing::beginTrace() {
+    onlineRAM::beginTrace();
+    resident.assign(pageID.width() / 64 + 1, 0);
+    ring.assign(max(noOfRAMPages, 1), 0);
+    nextFrame = 0;
+    loaded = 0;
+}
+
+void FIFORing::processBlock(traceView block) {
+    int frames = ring.size();
+    for (int id : block) {
+        if (resident[id >> 6] >> (id & 63) & 1)
+            continue;
+        missCount++;
+        if (loaded == frames) {
+            int victim = ring[nextFrame];
+            resident[victim >> 6] &= ~(1ULL << (victim & 63));
+        } else {
+            loaded++;
+        }
+        resident[id >> 6] |= 1ULL << (id & 63);
+        ring[nextFrame] = id;
+        nextFrame = (nextFrame + 1 == frames) ? 0 : nextFrame + 1;
+    }
+    total += block.size();
+}
+
+void CLOCK::beginTrace() {
+    onlineRAM::beginTrace();
+    frames.assign(max(noOfRAMPages, 1), 0);
+    frameOf.assign(pageID.width() + 1, -1);
+    referenced.assign(frames.size() / 64 + 1, 0);
+    hand = 0;
+    loaded = 0;
+}
+
+// Bits past the last frame are never set, so they only ever look unreferenced and are skipped by
+// the bound check
+int CLOCK::findVictim() {
+    int noOfFrames = frames.size();
+    while (true) {
+        int word = hand >> 6, offset = hand & 63;
+        int end = min((word + 1) << 6, noOfFrames);
+        uint64_t clear = ~referenced[word] >> offset;
+        if (clear != 0 && hand + __builtin_ctzll(clear) < end) {
+            int victim = hand + __builtin_ctzll(clear);
+            referenced[word] &= ~(((1ULL << (victim - hand)) - 1) << offset);
+            return victim;
+        }
+        referenced[word] &= (offset == 0) ? 0 : (1ULL << offset) - 1;
+        hand = (end == noOfFrames) ? 0 : end;
+    }
+}
+
+void CLOCK::processBlock(traceView block) {
+    int noOfFrames = frames.size();
+    for (int id : block) {
+        int frame = frameOf[id];
+        if (frame >= 0) {
+            referenced[frame >> 6] |= 1ULL << (frame & 63);
+            continue;
+        }
+        missCount++;
+        if (loaded < noOfFrames) {
+            frame = loaded++;
+        } else {
+            frame = findVictim();
+            frameOf[frames[frame]] = -1;
+            hand = (frame + 1 == noOfFrames) ? 0 : frame + 1;
+        }
+        frames[frame] = id;
+        frameOf[id] = frame;
+        if (loadReferenced)
+            referenced[frame >> 6] |= 1ULL << (frame & 63);
+    }
+    total += block.size();
+}
+
+void GCLOCK::beginTrace() {
+    onlineRAM::beginTrace();
+    counterBits = config::getInstance()->gclockBits;
+    frames.assign(max(noOfRAMPages, 1), 0);
+    frameOf.assign(pageID.width() + 1, -1);
+    counters.assign(frames.size() * counterBits / 64 + 1, 0);
+    hand = 0;
+    loaded = 0;
+}
+
+int GCLOCK::getCount(int frame) const {
+    size_t bit = (size_t)frame * counterBits;
+    return (counters[bit >> 6] >> (bit & 63)) & ((1ULL << counterBits) - 1);
+}
+
+void GCLOCK::setCount(int frame, int count) {
+    size_t bit = (size_t)frame * counterBits;
+    uint64_t mask = ((1ULL << counterBits) - 1) << (bit & 63);
+    counters[bit >> 6] = (counters[bit >> 6] & ~mask) | ((uint64_t)count << (bit & 63));
+}
+
+void GCLOCK::processBlock(traceView block) {
+    int noOfFrames = frames.size();
+    int maxCount = (1 << counterBits) - 1;
+    for (int id : block) {
+        int frame = frameOf[id];
+        if (frame >= 0) {
+            int count = getCount(frame);
+            if (count < maxCount)
+                setCount(frame, count + 1);
+            continue;
+        }
+        missCount++;
+        if (loaded < noOfFrames) {
+            frame = loaded++;
+        } else {
+            int count;
+            while ((count = getCount(hand)) > 0) {
+                setCount(hand, count - 1);
+                hand = (hand + 1 == noOfFrames) ? 0 : hand + 1;
+            }
+            frame = hand;
+            frameOf[frames[frame]] = -1;
+            hand = (frame + 1 == noOfFrames) ? 0 : frame + 1;
+        }
+        frames[frame] = id;
+        frameOf[id] = frame;
+        setCount(frame, 1);
+    }
+    total += block.size();
+}
+
+void ARC::beginTrace() {
+    onlineRAM::beginTrace();
+    sentinel = pageID.width();
+    prev.assign(sentinel + 5, 0);
+    next.assign(sentinel + 5, 0);
+    for (int list = T1; list <= B2; list++)
+        prev[sentinel + list] = next[sentinel + list] = sentinel + list;
+    listOf.assign(sentinel + 1, NONE);
+    fill(length, length + 5, 0);
+    target = 0;
+}
+
+int ARC::back(int list) const { return prev[sentinel + list]; }
+
+void ARC::pushFront(int list, int id) {
+    int head = sentinel + list;
+    prev[id] = head;
+    next[id] = next[head];
+    prev[next[head]] = id;
+    next[head] = id;
+    listOf[id] = list;
+    length[list]++;
+}
+
+void ARC::remove(int id) {
+    next[prev[id]] = next[id];
+    prev[next[id]] = prev[id];
+    length[listOf[id]]--;
+    listOf[id] = NONE;
+}
+
+// T1 gives up its page while it is over target; a miss on a T2 ghost also takes it at target
+void ARC::replace(bool ghostOfT2) {
+    int from = T2, to = B2;
+    if (length[T1] > 0 && (length[T1] > target || (ghostOfT2 && length[T1] == target))) {
+        from = T1;
+        to = B1;
+    }
+    int victim = back(from);
+    remove(victim);
+    pushFront(to, victim);
 }
 
-vector<int> LRU::processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) {
-    int missCount = 0, total = pageID.size();
-    set<pair<int,int>> cache;
-    unordered_map<int, int> lastUsed;
+// Ghosts only appear once the cache is full and it stays full from then on, so T1 and T2 together
+// hold noOfRAMPages pages whenever replace is called. L1 = T1 + B1 and the whole directory are
+// kept to at most one and two cache sizes by dropping the oldest ghosts.
+void ARC::processBlock(traceView block) {
+    int capacity = max(noOfRAMPages, 1);
+    for (int id : block) {
+        int list = listOf[id];
+        if (list == T1 || list == T2) {
+            remove(id);
+            pushFront(T2, id);
+            continue;
+        }
+        missCount++;
+        if (list == B1) {
+            target = min(capacity, target + max(length[B2] / length[B1], 1));
+            replace(false);
+            remove(id);
+            pushFront(T2, id);
+        } else if (list == B2) {
+            target = max(0, target - max(length[B1] / length[B2], 1));
+            replace(true);
+            remove(id);
+            pushFront(T2, id);
+        } else {
+            int recent = length[T1] + length[B1];
+            int known = recent + length[T2] + length[B2];
+            if (recent == capacity) {
+                if (length[T1] < capacity) {
+                    remove(back(B1));
+                    replace(false);
+                } else {
+                    remove(back(T1));
+                }
+            } else if (known >= capacity) {
+                if (known == 2 * capacity)
+                    remove(back(B2));
+                replace(false);
+            }
+            pushFront(T1, id);
+        }
+    }
+    total += block.size();
+}
 
-    for (int i = 0; i < total; i++) {
-        if (cache.find({pageID[i],lastUsed[pageID[i]]})==cache.end()) {
+void LRU::beginTrace() {
+    onlineRAM::beginTrace();
+    cache.clear();
+    lastUsed.clear();
+}
+
+void LRU::processBlock(traceView block) {
+    for (size_t j = 0; j < block.size(); j++) {
+        int id = block[j];
+        int64_t i = total + j;
+        if (cache.find({lastUsed[id],id})==cache.end()) {
             missCount++;
             if (cache.size() == noOfRAMPages) {
                 cache.erase(*cache.begin());
@@ -461,21 +3186,91 @@ vector<int> LRU::processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID)
         }
         else
         {
-            cache.erase({pageID[i],lastUsed[pageID[i]]});
+            cache.erase({lastUsed[id],id});
         }
-        cache.insert({pageID[i],i});
-        lastUsed[pageID[i]] = i;
+        cache.insert({i,id});
+        lastUsed[id] = i;
     }
-    return {missCount, total};
+    total += block.size();
+}
+
+void LRUStack::beginTrace() {
+    onlineRAM::beginTrace();
+    counter = stackDistance(pageID.width());
+}
+
+void LRUStack::processBlock(traceView block) {
+    counter.processBlock(block);
+    total += block.size();
+}
+
+stats LRUStack::endTrace() {
+    return {counter.getCurve().getMissCount(noOfRAMPages), total};
+}
+
+void LRUSampled::beginTrace() {
+    onlineRAM::beginTrace();
+    counter.reset(new sampledStackDistance(pageID.width(), config::getInstance()->sampleBudget));
+}
+
+void LRUSampled::processBlock(traceView block) {
+    counter->processBlock(block);
+    total += block.size();
+}
+
+stats LRUSampled::endTrace() {
+    return {counter->getCurve().getMissCount(noOfRAMPages), total};
+}
+
+void LRUList::beginTrace() {
+    onlineRAM::beginTrace();
+    cache = pageList(pageID.width());
+}
+
+void LRUList::processBlock(traceView block) {
+    for (int id : block) {
+        if (cache.contains(id)) {
+            cache.remove(id);
+        } else {
+            missCount++;
+            if (cache.size() == noOfRAMPages)
+                cache.remove(cache.back());
+        }
+        cache.pushFront(id);
+    }
+    total += block.size();
 }
 
-vector<int> MRU::processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) {
-    int missCount = 0, total = pageID.size();
-    set<pair<int,int>> cache;
-    unordered_map<int, int> lastUsed;
+void MRUList::beginTrace() {
+    onlineRAM::beginTrace();
+    cache = pageList(pageID.width());
+}
+
+void MRUList::processBlock(traceView block) {
+    for (int id : block) {
+        if (cache.contains(id)) {
+            cache.remove(id);
+        } else {
+            missCount++;
+            if (cache.size() == noOfRAMPages)
+                cache.remove(cache.front());
+        }
+        cache.pushFront(id);
+    }
+    total += block.size();
+}
+
+void MRU::beginTrace() {
+    onlineRAM::beginTrace();
+    cache.clear();
+    lastUsed.clear();
+}
 
-    for (int i = 0; i < total; i++) {
-        if (cache.find({pageID[i],lastUsed[pageID[i]]})==cache.end()) {
+void MRU::processBlock(traceView block) {
+    for (size_t j = 0; j < block.size(); j++) {
+        int id = block[j];
+        int64_t i = total + j;
+        if (cache.find({lastUsed[id],id})==cache.end()) {
             missCount++;
             if (cache.size() == noOfRAMPages) {
                 cache.erase(*(--cache.end()));
@@ -483,34 +3278,70 @@ vector<int> MRU::processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID)
         }
         else
         {
-            cache.erase({pageID[i],lastUsed[pageID[i]]});  
+            cache.erase({lastUsed[id],id});
         }
-        cache.insert({pageID[i],i});
-        lastUsed[pageID[i]] = i;
+        cache.insert({i,id});
+        lastUsed[id] = i;
     }
-    return {missCount, total};
+    total += block.size();
+}
+
+// When the view does not promise dense ids (width unknown, or much larger than the trace) the ids
+// are remapped to 1..distinct in one forward pass into storage, so callers can index flat arrays.
+traceView OPT::denseView(traceView pageID, vector<int> &storage) {
+    size_t total = pageID.size();
+    int width = pageID.width();
+    if (width > 0 && (size_t)width <= 4 * total + 64)
+        return pageID;
+
+    unordered_map<int, int> compact;
+    compact.reserve(min(total, (size_t)1 << 20));
+    storage.resize(total);
+    for (size_t i = 0; i < total; i++)
+        storage[i] = compact.emplace(pageID[i], (int)compact.size() + 1).first->second;
+    return traceView(storage, compact.size());
 }
 
-vector<int> OPT::processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID) {
-   int missCount = 0;
-    int total = pageID.size();
-    
-    vector<int> nxtOcc(total,total);
-    map<int,int> nearestOcc;
-    for(int i=total-1;i>=0;i--){
+// Backward pass over a dense last-seen array indexed by page id
+vector<size_t> OPT::nextOccurrence(traceView pageID) {
+    vector<int> remapped;
+    traceView ids = denseView(pageID, remapped);
+    size_t total = ids.size();
+    vector<size_t> nxtOcc(total);
+
+    vector<size_t> nearestOcc(ids.width() + 1, total);
+    for (size_t i = total; i-- > 0;) {
+        nxtOcc[i] = nearestOcc[ids[i]];
+        nearestOcc[ids[i]] = i;
+    }
+    return nxtOcc;
+}
+
+vector<size_t> OPT::nextOccurrenceByMap(traceView pageID) {
+    size_t total = pageID.size();
+    vector<size_t> nxtOcc(total,total);
+    map<int,size_t> nearestOcc;
+    for(size_t i=total;i-->0;){
         if(nearestOcc.find(pageID[i]) != nearestOcc.end()){
             nxtOcc[i] = nearestOcc[pageID[i]];
         }
         nearestOcc[pageID[i]] = i;
     }
+    return nxtOcc;
+}
+
+stats OPT::processRAM(int noOfPages, int noOfRAMPages, traceView pageID) {
+    int64_t missCount = 0;
+    size_t total = pageID.size();
+    vector<size_t> nxtOcc = nextOccurrence(pageID);
 
     unordered_set<int> chachedPages;
-    set<int> nxtOccOfChachedPages;
+    set<size_t> nxtOccOfChachedPages;
     unordered_set<int> noNextOcc;
-    for (int i = 0; i < pageID.size(); i++)
+    for (size_t i = 0; i < pageID.size(); i++)
     {
         if(!chachedPages.count(pageID[i])){
-            if((chachedPages.size() + noNextOcc.size()) == noOfRAMPages){
+            if((chachedPages.size() + noNextOcc.size()) == (size_t)noOfRAMPages){
                 if(noNextOcc.size()>0)
                 {
                     noNextOcc.erase(*noNextOcc.begin());
@@ -544,15 +3375,103 @@ vector<int> OPT::processRAM(int noOfPages, int noOfRAMPages, vector<int> pageID)
                 nxtOccOfChachedPages.insert(nxtOcc[i]);
         }
     }
-    return {missCount, total};
+    return {missCount, (int64_t)total};
+}
+
+stats OPTHeap::processRAM(int, int noOfRAMPages, traceView pageID) {
+    int64_t missCount = 0;
+    size_t total = pageID.size();
+    vector<int> remapped;
+    traceView ids = OPT::denseView(pageID, remapped);
+    vector<size_t> nxtOcc = OPT::nextOccurrence(ids);
+
+    // A next use inside the trace is the position of exactly one reference, so it identifies the page
+    // as ids[key]. Pages never used again get the key total + id instead, which sorts after every
+    // real next use and breaks their ties by id. The heap thus compares plain 64-bit integers.
+    const uint64_t absent = UINT64_MAX;
+    vector<uint64_t> heap;
+    heap.reserve(2 * (size_t)noOfRAMPages + 17);
+    vector<uint64_t> keyOf(ids.width() + 1, absent);               // Heap key of each resident page, absent if not resident
+    int loaded = 0;
+
+    for (size_t i = 0; i < total; i++) {
+        int id = ids[i];
+        if (keyOf[id] == absent) {
+            missCount++;
+            if (loaded == noOfRAMPages) {
+                while (true) {
+                    pop_heap(heap.begin(), heap.end());
+                    uint64_t top = heap.back();
+                    heap.pop_back();
+                    int victim = (top < total) ? ids[top] : (int)(top - total);
+                    if (keyOf[victim] == top) {
+                        keyOf[victim] = absent;
+                        loaded--;
+                        break;
+                    }
+                }
+            }
+            loaded++;
+        }
+        uint64_t key = (nxtOcc[i] < total) ? nxtOcc[i] : total + id;
+        keyOf[id] = key;
+        heap.push_back(key);
+        push_heap(heap.begin(), heap.end());
+
+        if (heap.size() > 2 * (size_t)noOfRAMPages + 16) {
+            heap.erase(remove_if(heap.begin(), heap.end(), [&](uint64_t entry) {
+                return keyOf[(entry < total) ? ids[entry] : (int)(entry - total)] != entry;
+            }), heap.end());
+            make_heap(heap.begin(), heap.end());
+        }
+    }
+    return {missCount, (int64_t)total};
+}
+
+stats OPTStack::processRAM(int, int noOfRAMPages, traceView pageID) {
+    missRatioCurve curve = missRatioCurve::createOPTCurve(pageID, noOfRAMPages);
+    return {curve.getMissCount(noOfRAMPages), curve.getTotal()};
 }
 
 // ------------------------------
 // Entry Point
 // ------------------------------
-int main() {
-    handler *run = handler::createHandler();
-    run->analyzeOnAllPageSize();
-    run->printAnalyzedData();
+// PageReplacementBenchmark.cpp includes this file with PAGE_REPLACEMENT_NO_MAIN defined
+#ifndef PAGE_REPLACEMENT_NO_MAIN
+int main(int argc, char *argv[]) {
+    if (!config::getInstance()->parseArguments(argc, argv))
+        return 1;
+
+    config *settings = config::getInstance();
+    if (settings->runs.empty()) {
+        handler *run = handler::createHandler();
+        if (!run->analyzeOnAllPageSize())
+            return 1;
+        run->printAnalyzedData();
+        return 0;
+    }
+
+    // Batch runs share the process, so the pool, arenas and engine registry are set up once; each
+    // run applies its own options on top of the command line and the settings are restored after it
+    vector<config::batchRun> runs = settings->runs;
+    for (size_t i = 0; i < runs.size(); i++) {
+        config saved = *settings;
+        unordered_map<string, algoData *> savedMapping = mapping;
+        settings->applyRun(runs[i]);
+
+        cout << "Run " << i + 1 << "/" << runs.size() << ": " << runs[i].description << endl;
+        unique_ptr<handler> run(handler::createHandler(runs[i].noOfProcess, runs[i].RAMSize, runs[i].processSize));
+        bool completed = run->analyzeOnAllPageSize();
+        if (completed)
+            run->printAnalyzedData();
+
+        *settings = saved;
+        mapping = savedMapping;
+        if (!completed)
+            return 1;
+        if (i + 1 < runs.size())
+            cout << endl;
+    }
     return 0;
 }
+#endif
@@ -0,0 +1,685 @@
+/**********************************************************************************
+ * Project Name : Page Replacement Algorithm Analyzer - Benchmark
+ * Description  : Times every registered engine (see `engines`) on a matrix of
+                  trace lengths, footprints and frame counts and reports
+                  throughput, latency per reference and peak heap usage, so
+                  regressions in the hot loops show up before they reach a sweep.
+
+                  Each case runs a number of untimed warmup rounds followed by
+                  timed repetitions on the same trace; the median repetition is
+                  reported. Peak memory is the highest number of live heap bytes
+                  during a repetition, tracked through the global allocator.
+
+                  With --verify it times nothing and instead checks the miss
+                  count of every engine against a naive simulation of its
+                  policy on random traces, exiting non-zero on a mismatch.
+ **********************************************************************************/
+
+#define PAGE_REPLACEMENT_NO_MAIN
+#include "PageReplacementAnalyzer.cpp"
+
+// ------------------------------
+// Heap accounting
+// ------------------------------
+// Every allocation carries its size in a 16-byte prefix so that frees can be accounted for.
+// The operators are kept out of line so the compiler does not pair their malloc/free with callers.
+static size_t liveBytes = 0;                                       // Heap bytes currently allocated
+static size_t peakBytes = 0;                                       // Highest liveBytes since the last reset
+
+__attribute__((noinline)) void *operator new(size_t size) {
+    char *block = (char *)malloc(size + 16);
+    if (block == NULL)
+        throw bad_alloc();
+    *(size_t *)block = size;
+    liveBytes += size;
+    peakBytes = max(peakBytes, liveBytes);
+    return block + 16;
+}
+
+__attribute__((noinline)) void operator delete(void *pointer) noexcept {
+    if (pointer == NULL)
+        return;
+    char *block = (char *)pointer - 16;
+    liveBytes -= *(size_t *)block;
+    free(block);
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *pointer) noexcept { operator delete(pointer); }
+void operator delete(void *pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { operator delete(pointer); }
+
+// Class to run one engine on one benchmark configuration
+class benchmarkCase {
+public:
+    string engineName;                                             // Key in engines
+    size_t traceLength;                                            // References in the trace
+    int noOfPages;                                                 // Footprint: ids are drawn from [1, noOfPages]
+    int noOfRAMPages;                                              // Frames available to the engine
+    double nsPerReference;                                          // Median time per reference
+    double hitRate;                                                // Fraction of references that hit
+    size_t peakMemory;                                             // Peak heap bytes of one repetition
+
+    benchmarkCase(string engineName, size_t traceLength, int noOfPages, int noOfRAMPages); // Constructor
+    void run(traceView trace, int warmup, int repetitions);        // Measure the engine on the trace
+};
+
+// Naive simulations of each policy over a plain vector of frames: quadratic, but short enough to
+// check by eye, so --verify can hold the engines to them
+class naiveReference {
+public:
+    static int64_t simulateFIFO(const vector<int> &pageID, int noOfRAMPages); // Evict the oldest load
+    static int64_t simulateLRU(const vector<int> &pageID, int noOfRAMPages); // Evict the least recent use
+    static int64_t simulateMRU(const vector<int> &pageID, int noOfRAMPages); // Evict the most recent use
+    static int64_t simulateOPT(const vector<int> &pageID, int noOfRAMPages); // Evict the farthest next use
+    static int64_t simulateClock(const vector<int> &pageID, int noOfRAMPages, int loadCount, int maxCount); // Evict where the hand finds a 0
+    static int64_t simulateARC(const vector<int> &pageID, int noOfRAMPages); // Adaptive Replacement Cache
+};
+
+// Class to build the benchmark matrix, run it and print the results
+class benchmark {
+    int warmup;                                                    // Untimed rounds per case
+    int repetitions;                                               // Timed rounds per case
+    string filter;                                                 // Only engines whose name contains this
+    string workloadSpec;                                           // Access pattern of the benchmark traces
+    bool verifying;                                                // Check engines against naive references instead of timing
+    vector<size_t> traceLengths;                                   // Matrix axis: trace length
+    vector<int> footprints;                                        // Matrix axis: distinct pages
+    vector<int> frameDivisors;                                     // Matrix axis: frames = footprint / divisor
+
+    benchmark();                                                   // Private constructor
+
+public:
+    static benchmark *createBenchmark(int argc, char *argv[]);     // Factory method, NULL on bad arguments
+    bool runAll();                                                 // Run and print every case, false if verification failed
+
+private:
+    void runPreprocessing();                                       // Compare OPT next-occurrence passes
+    void runGeneration();                                          // Trace generation throughput per workload
+    void runSampling();                                            // Sampled LRU curves against the exact ones
+    void runAdaptive();                                            // ARC against LRU on patterns that favour each
+    bool runVerification();                                        // Every engine against its naive reference, false on a mismatch
+    double timeNanosPerReference(function<void()> body, size_t references); // Median of the timed rounds
+    vector<int> createTrace(size_t traceLength, int noOfPages) const; // Trace of the workload with a fixed key
+    static void printTable(const vector<benchmarkCase> &cases);   // Aligned result table
+    static void printRows(const vector<vector<string>> &table);    // Print rows with aligned columns
+};
+
+// ------------------------------
+// Definition: benchmarkCase class
+// ------------------------------
+benchmarkCase::benchmarkCase(string engineName, size_t traceLength, int noOfPages, int noOfRAMPages) {
+    this->engineName = engineName;
+    this->traceLength = traceLength;
+    this->noOfPages = noOfPages;
+    this->noOfRAMPages = noOfRAMPages;
+    this->nsPerReference = 0;
+    this->hitRate = 0;
+    this->peakMemory = 0;
+}
+
+void benchmarkCase::run(traceView trace, int warmup, int repetitions) {
+    algoData *algo = engines[engineName];
+    arena scratch;
+    vector<double> timings;
+    volatile int sink = 0;
+
+    for (int round = 0; round < warmup + repetitions; round++) {
+        size_t baseline = liveBytes;
+        peakBytes = liveBytes;
+        auto start = chrono::steady_clock::now();
+
+        RAM *algoInstance = algo->createFunction(scratch, noOfRAMPages, noOfPages, trace);
+        stats result = algoInstance->processRAM(noOfPages, noOfRAMPages, trace);
+        scratch.release();
+
+        auto finish = chrono::steady_clock::now();
+        sink = sink + (int)result.missCount;
+        hitRate = 1.0 * (result.total - result.missCount) / result.total;
+        if (round < warmup)
+            continue;
+        timings.push_back(chrono::duration<double, nano>(finish - start).count() / trace.size());
+        peakMemory = max(peakMemory, peakBytes - baseline);
+    }
+
+    sort(timings.begin(), timings.end());
+    nsPerReference = timings[timings.size() / 2];
+}
+
+// ------------------------------
+// Definition: naiveReference class
+// ------------------------------
+int64_t naiveReference::simulateFIFO(const vector<int> &pageID, int noOfRAMPages) {
+    vector<int> frames;                                            // Oldest load first
+    int64_t missCount = 0;
+    for (int id : pageID) {
+        if (find(frames.begin(), frames.end(), id) != frames.end())
+            continue;
+        missCount++;
+        if ((int)frames.size() == noOfRAMPages)
+            frames.erase(frames.begin());
+        frames.push_back(id);
+    }
+    return missCount;
+}
+
+int64_t naiveReference::simulateLRU(const vector<int> &pageID, int noOfRAMPages) {
+    vector<int> frames;                                            // Least recent use first
+    int64_t missCount = 0;
+    for (int id : pageID) {
+        auto found = find(frames.begin(), frames.end(), id);
+        if (found != frames.end()) {
+            frames.erase(found);
+        } else {
+            missCount++;
+            if ((int)frames.size() == noOfRAMPages)
+                frames.erase(frames.begin());
+        }
+        frames.push_back(id);
+    }
+    return missCount;
+}
+
+int64_t naiveReference::simulateMRU(const vector<int> &pageID, int noOfRAMPages) {
+    vector<int> frames;                                            // Least recent use first
+    int64_t missCount = 0;
+    for (int id : pageID) {
+        auto found = find(frames.begin(), frames.end(), id);
+        if (found != frames.end()) {
+            frames.erase(found);
+        } else {
+            missCount++;
+            if ((int)frames.size() == noOfRAMPages)
+                frames.pop_back();
+        }
+        frames.push_back(id);
+    }
+    return missCount;
+}
+
+// Pages never used again have next use pageID.size(); which of them goes first does not change the count
+int64_t naiveReference::simulateOPT(const vector<int> &pageID, int noOfRAMPages) {
+    vector<size_t> nextUse(pageID.size());
+    map<int, size_t> seenAt;
+    for (size_t i = pageID.size(); i-- > 0;) {
+        auto seen = seenAt.find(pageID[i]);
+        nextUse[i] = (seen == seenAt.end()) ? pageID.size() : seen->second;
+        seenAt[pageID[i]] = i;
+    }
+
+    vector<pair<int, size_t>> frames;                              // Resident page and its next use
+    int64_t missCount = 0;
+    for (size_t i = 0; i < pageID.size(); i++) {
+        auto found = find_if(frames.begin(), frames.end(), [&](const pair<int, size_t> &frame) { return frame.first == pageID[i]; });
+        if (found != frames.end()) {
+            found->second = nextUse[i];
+            continue;
+        }
+        missCount++;
+        if ((int)frames.size() == noOfRAMPages)
+            frames.erase(max_element(frames.begin(), frames.end(), [](const pair<int, size_t> &a, const pair<int, size_t> &b) { return a.second < b.second; }));
+        frames.push_back({pageID[i], nextUse[i]});
+    }
+    return missCount;
+}
+
+// A counter per frame: pages are loaded with loadCount, a hit adds 1 up to maxCount, and on a miss the
+// hand decrements counters until it finds a 0, replaces that page and moves past it. CLOCK is
+// (1, 1), second chance (0, 1) and GCLOCK (1, 2^bits - 1).
+int64_t naiveReference::simulateClock(const vector<int> &pageID, int noOfRAMPages, int loadCount, int maxCount) {
+    vector<int> frames, counter;
+    int hand = 0;
+    int64_t missCount = 0;
+    for (int id : pageID) {
+        auto found = find(frames.begin(), frames.end(), id);
+        if (found != frames.end()) {
+            int &count = counter[found - frames.begin()];
+            count = min(count + 1, maxCount);
+            continue;
+        }
+        missCount++;
+        if ((int)frames.size() < noOfRAMPages) {
+            frames.push_back(id);
+            counter.push_back(loadCount);
+            continue;
+        }
+        while (counter[hand] > 0) {
+            counter[hand]--;
+            hand = (hand + 1) % noOfRAMPages;
+        }
+        frames[hand] = id;
+        counter[hand] = loadCount;
+        hand = (hand + 1) % noOfRAMPages;
+    }
+    return missCount;
+}
+
+// Line-by-line transcription of the ARC pseudocode of Megiddo and Modha on four lists, most recent
+// first; target is p, the size of T1 the cache aims for
+int64_t naiveReference::simulateARC(const vector<int> &pageID, int noOfRAMPages) {
+    list<int> T1, T2, B1, B2;
+    double target = 0;
+    int c = noOfRAMPages;
+    int64_t missCount = 0;
+    auto contains = [](const list<int> &pages, int id) { return find(pages.begin(), pages.end(), id) != pages.end(); };
+    auto replace = [&](int id) {
+        if (!T1.empty() && ((int)T1.size() > target || (contains(B2, id) && (int)T1.size() == target))) {
+            B1.push_front(T1.back());
+            T1.pop_back();
+        } else {
+            B2.push_front(T2.back());
+            T2.pop_back();
+        }
+    };
+
+    for (int id : pageID) {
+        if (contains(T1, id) || contains(T2, id)) {
+            T1.remove(id);
+            T2.remove(id);
+            T2.push_front(id);
+            continue;
+        }
+        missCount++;
+        if (contains(B1, id)) {
+            target = min((double)c, target + max((int)(B2.size() / B1.size()), 1));
+            replace(id);
+            B1.remove(id);
+            T2.push_front(id);
+        } else if (contains(B2, id)) {
+            target = max(0.0, target - max((int)(B1.size() / B2.size()), 1));
+            replace(id);
+            B2.remove(id);
+            T2.push_front(id);
+        } else {
+            int L1 = T1.size() + B1.size(), all = L1 + T2.size() + B2.size();
+            if (L1 == c) {
+                if ((int)T1.size() < c) {
+                    B1.pop_back();
+                    replace(id);
+                } else {
+                    T1.pop_back();
+                }
+            } else if (all >= c) {
+                if (all == 2 * c)
+                    B2.pop_back();
+                replace(id);
+            }
+            T1.push_front(id);
+        }
+    }
+    return missCount;
+}
+
+// ------------------------------
+// Definition: benchmark class
+// ------------------------------
+benchmark::benchmark() {
+    this->warmup = 1;
+    this->repetitions = 5;
+    this->traceLengths = {1 << 16, 1 << 20};
+    this->footprints = {64, 1024, 16384};
+    this->frameDivisors = {8, 2};
+    this->workloadSpec = "uniform";
+    this->verifying = false;
+}
+
+benchmark *benchmark::createBenchmark(int argc, char *argv[]) {
+    benchmark *bench = new benchmark();
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--warmup" && i + 1 < argc) {
+            bench->warmup = max(0, atoi(argv[++i]));
+        } else if (option == "--repetitions" && i + 1 < argc) {
+            bench->repetitions = max(1, atoi(argv[++i]));
+        } else if (option == "--filter" && i + 1 < argc) {
+            bench->filter = argv[++i];
+        } else if (option == "--workload" && i + 1 < argc) {
+            bench->workloadSpec = argv[++i];
+            if (!unique_ptr<workload>(workload::createWorkload(bench->workloadSpec, 1))) {
+                cerr << "Invalid workload: " << bench->workloadSpec << endl;
+                delete bench;
+                return NULL;
+            }
+        } else if (option == "--quick") {
+            bench->traceLengths = {1 << 16};
+            bench->footprints = {1024};
+        } else if (option == "--verify") {
+            bench->verifying = true;
+        } else {
+            cerr << "Unknown option: " << option << endl;
+            cerr << "Usage: PageReplacementBenchmark [--warmup N] [--repetitions N] [--filter TEXT] [--workload SPEC]"
+                 << " [--quick] [--verify]" << endl;
+            delete bench;
+            return NULL;
+        }
+    }
+    return bench;
+}
+
+vector<int> benchmark::createTrace(size_t traceLength, int noOfPages) const {
+    unique_ptr<workload> pattern(workload::createWorkload(workloadSpec, noOfPages));
+    vector<int> pageID(traceLength);
+    pattern->fillAt(pageID.data(), 12345, 0, traceLength);
+    return pageID;
+}
+
+bool benchmark::runAll() {
+    if (verifying)
+        return runVerification();
+
+    vector<string> engineNames;
+    for (auto &it : engines)
+        if (it.first.find(filter) != string::npos)
+            engineNames.push_back(it.first);
+    sort(engineNames.begin(), engineNames.end());
+
+    vector<benchmarkCase> cases;
+    for (size_t traceLength : traceLengths) {
+        for (int noOfPages : footprints) {
+            vector<int> pageID = createTrace(traceLength, noOfPages);
+            traceView trace(pageID, noOfPages);
+            for (int divisor : frameDivisors) {
+                for (const string &engineName : engineNames) {
+                    cases.push_back(benchmarkCase(engineName, traceLength, noOfPages, max(1, noOfPages / divisor)));
+                    cases.back().run(trace, warmup, repetitions);
+                }
+            }
+        }
+    }
+    printTable(cases);
+    runPreprocessing();
+    runSampling();
+    runAdaptive();
+    runGeneration();
+    return true;
+}
+
+double benchmark::timeNanosPerReference(function<void()> body, size_t references) {
+    vector<double> timings;
+    for (int round = 0; round < warmup + repetitions; round++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        auto finish = chrono::steady_clock::now();
+        if (round >= warmup)
+            timings.push_back(chrono::duration<double, nano>(finish - start).count() / references);
+    }
+    sort(timings.begin(), timings.end());
+    return timings[timings.size() / 2];
+}
+
+// OPT's next-occurrence pass timed on its own: dense array, sparse ids through the remapping
+// fallback, and the map-based version the dense one replaced
+void benchmark::runPreprocessing() {
+    if (string("OPT").find(filter) == string::npos && filter.find("OPT") == string::npos)
+        return;
+
+    cout << endl << "OPT next-occurrence preprocessing (ns/ref):" << endl;
+    vector<vector<string>> table = {{"References", "Pages", "dense", "remapped", "map"}};
+    for (size_t traceLength : traceLengths) {
+        for (int noOfPages : footprints) {
+            vector<int> pageID = createTrace(traceLength, noOfPages);
+            vector<int> sparseID(pageID.size());
+            for (size_t i = 0; i < pageID.size(); i++)
+                sparseID[i] = pageID[i] * 7919;
+            traceView dense(pageID, noOfPages), sparse(sparseID, 0);
+            volatile int sink = 0;
+
+            vector<double> timings = {
+                timeNanosPerReference([&] { sink = sink + OPT::nextOccurrence(dense)[0]; }, traceLength),
+                timeNanosPerReference([&] { sink = sink + OPT::nextOccurrence(sparse)[0]; }, traceLength),
+                timeNanosPerReference([&] { sink = sink + OPT::nextOccurrenceByMap(dense)[0]; }, traceLength)};
+            vector<string> row = {to_string(traceLength), to_string(noOfPages)};
+            for (double timing : timings) {
+                ostringstream cell;
+                cell << fixed << setprecision(2) << timing;
+                row.push_back(cell.str());
+            }
+            table.push_back(row);
+        }
+    }
+    printRows(table);
+}
+
+// The curve LRU:shards estimates from a sample of sampleBudget pages against the exact stack-distance
+// curve over every frame count: mean and largest absolute miss-ratio error, and the time of both
+void benchmark::runSampling() {
+    if (string("LRU:shards").find(filter) == string::npos && filter.find("shards") == string::npos)
+        return;
+
+    cout << endl << "Sampled LRU miss-ratio curve against the exact curve:" << endl;
+    vector<vector<string>> table = {{"Workload", "References", "Pages", "Budget", "Mean error", "Max error",
+                                     "exact ms", "sampled ms"}};
+    size_t traceLength = traceLengths.back();
+    for (string spec : {"uniform", "zipf:0.99", "phases:0.1,10", "zipf:0.99@0.7+scan@0.3"}) {
+        for (int noOfPages : footprints) {
+            unique_ptr<workload> pattern(workload::createWorkload(spec, noOfPages));
+            vector<int> pageID(traceLength);
+            pattern->fillAt(pageID.data(), 12345, 0, traceLength);
+            traceView trace(pageID, noOfPages);
+
+            auto start = chrono::steady_clock::now();
+            missRatioCurve exact = missRatioCurve::createLRUCurve(trace);
+            double exactTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            for (int sampleBudget : {256, 8192}) {
+                start = chrono::steady_clock::now();
+                missRatioCurve sampled = missRatioCurve::createSampledLRUCurve(trace, sampleBudget);
+                double sampledTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+                double meanError = 0, maxError = 0;
+                for (int frames = 1; frames <= noOfPages; frames++) {
+                    double error = fabs(exact.getMissRatio(frames) - sampled.getMissRatio(frames));
+                    meanError += error / noOfPages;
+                    maxError = max(maxError, error);
+                }
+                vector<string> row = {spec, to_string(traceLength), to_string(noOfPages), to_string(sampleBudget)};
+                for (double value : {meanError, maxError}) {
+                    ostringstream cell;
+                    cell << fixed << setprecision(4) << value;
+                    row.push_back(cell.str());
+                }
+                for (double value : {exactTime, sampledTime}) {
+                    ostringstream cell;
+                    cell << fixed << setprecision(1) << value;
+                    row.push_back(cell.str());
+                }
+                table.push_back(row);
+            }
+        }
+    }
+    printRows(table);
+}
+
+// ARC against the set-based LRU class and the list LRU engine: hit rate and throughput on traces
+// where recency is enough, on a loop larger than the frames, and on a hot set disturbed by scans
+void benchmark::runAdaptive() {
+    if (string("ARC:list").find(filter) == string::npos && filter.find("ARC") == string::npos)
+        return;
+
+    vector<string> engineNames = {"LRU:set", "LRU:list", "ARC:list"};
+    cout << endl << "ARC against LRU:" << endl;
+    vector<vector<string>> table = {{"Workload", "Pages", "Frames"}};
+    for (const string &engineName : engineNames)
+        table[0].push_back(engineName + " hit rate");
+    for (const string &engineName : engineNames)
+        table[0].push_back(engineName + " Mref/s");
+    size_t traceLength = traceLengths.back();
+    for (string spec : {"uniform", "zipf:0.99", "loop:0.5", "zipf:0.99@0.7+scan@0.3"}) {
+        for (int noOfPages : footprints) {
+            unique_ptr<workload> pattern(workload::createWorkload(spec, noOfPages));
+            vector<int> pageID(traceLength);
+            pattern->fillAt(pageID.data(), 12345, 0, traceLength);
+            traceView trace(pageID, noOfPages);
+            for (int divisor : frameDivisors) {
+                int noOfRAMPages = max(1, noOfPages / divisor);
+                vector<string> row = {spec, to_string(noOfPages), to_string(noOfRAMPages)};
+                vector<string> throughputs;
+                for (const string &engineName : engineNames) {
+                    benchmarkCase curCase(engineName, traceLength, noOfPages, noOfRAMPages);
+                    curCase.run(trace, warmup, repetitions);
+                    ostringstream hitRate, throughput;
+                    hitRate << fixed << setprecision(4) << curCase.hitRate;
+                    throughput << fixed << setprecision(1) << 1e3 / curCase.nsPerReference;
+                    row.push_back(hitRate.str());
+                    throughputs.push_back(throughput.str());
+                }
+                row.insert(row.end(), throughputs.begin(), throughputs.end());
+                table.push_back(row);
+            }
+        }
+    }
+    printRows(table);
+}
+
+// Every engine whose name passes the filter, on short traces of every kind of workload over small
+// footprints and frame counts on both sides of them, so evictions, ties and warm-up are all exercised.
+// Each engine runs twice: through processRAM, and online engines also through the block interface in
+// blocks of random sizes, as the fused pass feeds them. LRU:shards is exact here since no footprint
+// exceeds the sample budget, and CLOCK:gclock cycles through every counter width from trace to
+// trace. Prints a table of cases per engine and the first mismatches found.
+bool benchmark::runVerification() {
+    map<string, function<int64_t(const vector<int> &, int)>> references = {
+        {"OPT:set", naiveReference::simulateOPT}, {"OPT:heap", naiveReference::simulateOPT},
+        {"OPT:stack", naiveReference::simulateOPT}, {"FIFO:queue", naiveReference::simulateFIFO},
+        {"FIFO:ring", naiveReference::simulateFIFO}, {"LRU:set", naiveReference::simulateLRU},
+        {"LRU:stack", naiveReference::simulateLRU}, {"LRU:shards", naiveReference::simulateLRU},
+        {"LRU:list", naiveReference::simulateLRU}, {"MRU:set", naiveReference::simulateMRU},
+        {"MRU:list", naiveReference::simulateMRU},
+        {"CLOCK:clock", [](const vector<int> &pageID, int noOfRAMPages) { return naiveReference::simulateClock(pageID, noOfRAMPages, 1, 1); }},
+        {"CLOCK:second-chance", [](const vector<int> &pageID, int noOfRAMPages) { return naiveReference::simulateClock(pageID, noOfRAMPages, 0, 1); }},
+        {"CLOCK:gclock", [](const vector<int> &pageID, int noOfRAMPages)
+         { return naiveReference::simulateClock(pageID, noOfRAMPages, 1, (1 << config::getInstance()->gclockBits) - 1); }},
+        {"ARC:list", naiveReference::simulateARC}};
+    vector<string> engineNames;
+    for (auto &it : engines)
+        if (it.first.find(filter) != string::npos)
+            engineNames.push_back(it.first);
+    sort(engineNames.begin(), engineNames.end());
+
+    map<string, int> cases, mismatches;
+    uint64_t key = 0;
+    arena scratch;
+    int gclockBits = config::getInstance()->gclockBits;
+    for (string spec : {"uniform", "zipf:0.99", "scan", "loop:0.5", "phases:0.1,10", "zipf:0.99@0.7+scan@0.3"}) {
+        for (int noOfPages : {1, 3, 17, 100, 600}) {
+            for (size_t traceLength : {1, 300, 5000}) {
+                unique_ptr<workload> pattern(workload::createWorkload(spec, noOfPages));
+                vector<int> pageID(traceLength);
+                pattern->fillAt(pageID.data(), ++key, 0, traceLength);
+                traceView trace(pageID, noOfPages);
+                config::getInstance()->gclockBits = 1 << (key % 4);
+                for (int noOfRAMPages : set<int>{1, 2, max(1, noOfPages / 2), max(1, noOfPages - 1), noOfPages, noOfPages + 3}) {
+                    for (const string &engineName : engineNames) {
+                        auto reference = references.find(engineName);
+                        if (reference == references.end())
+                            continue;
+                        int64_t expected = reference->second(pageID, noOfRAMPages);
+                        algoData *algo = engines[engineName];
+                        vector<int64_t> found = {algo->createFunction(scratch, noOfRAMPages, noOfPages, trace)
+                                                     ->processRAM(noOfPages, noOfRAMPages, trace).missCount};
+                        onlineRAM *onlineInstance = dynamic_cast<onlineRAM *>(algo->createFunction(scratch, noOfRAMPages, noOfPages, trace));
+                        if (onlineInstance != NULL) {
+                            onlineInstance->beginTrace();
+                            for (size_t first = 0, block = 0; first < traceLength; first += block) {
+                                block = min(traceLength - first, (size_t)(1 + workload::random(key, first) % 700));
+                                onlineInstance->processBlock(trace.slice(first, block));
+                            }
+                            found.push_back(onlineInstance->endTrace().missCount);
+                        }
+                        scratch.release();
+
+                        cases[engineName]++;
+                        for (int64_t missCount : found) {
+                            if (missCount == expected)
+                                continue;
+                            if (mismatches[engineName]++ < 3)
+                                cerr << "Mismatch: " << engineName << " on " << spec << ", " << traceLength << " references over "
+                                     << noOfPages << " pages, " << noOfRAMPages << " frames: " << missCount
+                                     << " misses, expected " << expected << endl;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    config::getInstance()->gclockBits = gclockBits;
+
+    cout << "Engines against naive references:" << endl;
+    vector<vector<string>> table = {{"Engine", "Cases", "Mismatches"}};
+    int total = 0;
+    for (const string &engineName : engineNames) {
+        bool checked = references.count(engineName) > 0;
+        table.push_back({engineName, checked ? to_string(cases[engineName]) : "no reference",
+                         checked ? to_string(mismatches[engineName]) : "-"});
+        total += mismatches[engineName];
+    }
+    printRows(table);
+    return total == 0;
+}
+
+// Every kind of workload, plus a mixture, generated into a buffer the size of a fused block
+void benchmark::runGeneration() {
+    if (!filter.empty())
+        return;
+
+    vector<string> specs = {"uniform", "zipf:0.99", "scan", "loop:0.5", "phases:0.1,10", "zipf:0.99@0.7+scan@0.3"};
+    cout << endl << "Trace generation (Mref/s):" << endl;
+    vector<vector<string>> table = {{"Pages"}};
+    for (const string &spec : specs)
+        table[0].push_back(spec);
+    for (int noOfPages : footprints) {
+        vector<string> row = {to_string(noOfPages)};
+        for (const string &spec : specs) {
+            unique_ptr<workload> pattern(workload::createWorkload(spec, noOfPages));
+            size_t references = traceLengths.back();
+            vector<int> chunk(FUSED_BLOCK_SIZE);
+            double timing = timeNanosPerReference([&] {
+                for (size_t first = 0; first < references; first += chunk.size())
+                    pattern->fillAt(chunk.data(), 12345, first, min(chunk.size(), references - first));
+            }, references);
+            ostringstream cell;
+            cell << fixed << setprecision(1) << 1e3 / timing;
+            row.push_back(cell.str());
+        }
+        table.push_back(row);
+    }
+    printRows(table);
+}
+
+void benchmark::printTable(const vector<benchmarkCase> &cases) {
+    vector<vector<string>> table = {{"Engine", "References", "Pages", "Frames", "ns/ref", "Mref/s", "Peak heap (KiB)"}};
+    for (const benchmarkCase &curCase : cases) {
+        ostringstream nsPerReference, throughput;
+        nsPerReference << fixed << setprecision(2) << curCase.nsPerReference;
+        throughput << fixed << setprecision(1) << 1e3 / curCase.nsPerReference;
+        table.push_back({curCase.engineName, to_string(curCase.traceLength), to_string(curCase.noOfPages),
+                         to_string(curCase.noOfRAMPages), nsPerReference.str(), throughput.str(),
+                         to_string((curCase.peakMemory + 1023) / 1024)});
+    }
+    printRows(table);
+}
+
+void benchmark::printRows(const vector<vector<string>> &table) {
+    vector<size_t> width(table[0].size(), 0);
+    for (auto &row : table)
+        for (size_t j = 0; j < row.size(); j++)
+            width[j] = max(width[j], row[j].size());
+
+    for (auto &row : table) {
+        string line = "| ";
+        for (size_t j = 0; j < row.size(); j++)
+            line += row[j] + string(width[j] - row[j].size(), ' ') + " | ";
+        cout << line << endl;
+    }
+}
+
+// ------------------------------
+// Entry Point
+// ------------------------------
+int main(int argc, char *argv[]) {
+    benchmark *bench = benchmark::createBenchmark(argc, argv);
+    if (bench == NULL)
+        return 1;
+    return bench->runAll() ? 0 : 1;
+}